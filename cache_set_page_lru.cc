@@ -5,8 +5,9 @@
 // Implement Stacked-DRAM page-based cache set with LRU replacement
 
 
-CacheSetInfoPageLRU::CacheSetInfoPageLRU(UInt32 associativity)
-	: m_associativity(associativity)
+CacheSetInfoPageLRU::CacheSetInfoPageLRU(UInt32 associativity, DramCacheReplPolicy* repl_policy)
+	: m_repl_policy(repl_policy),
+	  m_associativity(associativity)
 {
 	m_access = new UInt64[m_associativity];
 	for (UInt32 i = 0; i < m_associativity; i++) {
@@ -17,18 +18,21 @@ CacheSetInfoPageLRU::CacheSetInfoPageLRU(UInt32 associativity)
 CacheSetInfoPageLRU::~CacheSetInfoPageLRU()
 {
 	delete [] m_access;
+	delete m_repl_policy;
 }
 
 CacheSetPageLRU::CacheSetPageLRU(
-		UInt32 associativity, UInt32 blocksize, CacheSetInfoPageLRU* set_info) 
+		UInt32 associativity, UInt32 blocksize, CacheSetInfoPageLRU* set_info, UInt32 set_index) 
 		: CacheSet(CacheBase::STACKED_DRAM_CACHE, associativity, blocksize),
 		  reads(0),
 		  writes(0),
-		  m_set_info(set_info)
+		  m_set_info(set_info),
+		  m_set_index(set_index)
 {
+	// replacement state of each way (age or RRPV)
 	m_lru_bits = new UInt8[m_associativity];
 	for (UInt32 i = 0; i < m_associativity; i++) {
-		m_lru_bits[i] = i;
+		m_lru_bits[i] = ~0;
 	}
 
 	m_cache_page_info_array = new CachePageInfo*[m_associativity];
@@ -50,15 +54,13 @@ UInt32
 CacheSetPageLRU::getReplacementIndex(CacheCntlr* tlr)
 {
 	reads++;
-	UInt8 max_t = 0;
-	UInt32 index = 0;
+	bool valid[DramCacheReplPolicy::MaxAssociativity];
+	UInt32 valid_blocks[DramCacheReplPolicy::MaxAssociativity];
 	for (UInt32 i = 0; i < m_associativity; i++) {
-		if (m_cache_page_info_array[i]->getUsage() > max_t) {
-			max_t = m_cache_page_info_array[i]->getUsage();
-			index = i;
-		}
+		valid[i] = m_cache_page_info_array[i]->isValid();
+		valid_blocks[i] = m_cache_page_info_array[i]->getValidBits();
 	}
-	return index;
+	return m_set_info->m_repl_policy->getVictim(m_set_index, m_lru_bits, valid, valid_blocks);
 }
 
 void
@@ -74,18 +76,8 @@ CacheSetPageLRU::updateUsedInfo(IntPtr tag)
 	if (index == m_associativity) {
 		std::cout << "ERROR: update tag" << std::endl;
 		return;
-	} else {
-		if (m_cache_page_info_array[index]->getUsage() != 0) {
-			for (UInt32 i = 0; i < m_associativity; i++) {
-				if (index == i) {
-					m_cache_page_info_array[i]->updateUsage(0);
-				} else {
-					UInt8 tmp = m_cache_page_info_array[i]->getUsage();
-					m_cache_page_info_array[i]->updateUsage(tmp + 1);
-				}
-			}
-		}
 	}
+	m_set_info->m_repl_policy->onFill(m_set_index, m_lru_bits, index);
 }
 
 void
@@ -120,15 +112,13 @@ CacheSetPageLRU::accessAttempt(Core::mem_op_t type, IntPtr tag, IntPtr offset)
 	for (UInt32 i = 0; i < m_associativity; i++) {
 		CachePageInfo *page = m_cache_page_info_array[i];
 		if (page->getTag() == tag) {
+			m_set_info->m_repl_policy->onHit(m_set_index, m_lru_bits, i);
 			if (page->accessBlock(type, block_num)) {
 				res = 2;
 			} else {
 				res = 1;
-<<<<<<< HEAD
 				// reload block
 				writes++;
-=======
->>>>>>> 836c84e6a7ff8170f36181a0cb7498834a3da90d
 			}
 			break;
 		}
@@ -3,6 +3,7 @@
 
 #include "cache_set.h"
 #include "cache_page_info.h"
+#include "dram_cache_replacement.h"
 
 #include "core.h"
 
@@ -11,12 +12,15 @@
 class CacheSetInfoPageLRU : public CacheSetInfo
 {
 	public:
-		CacheSetInfoPageLRU(UInt32 associativity);
+		CacheSetInfoPageLRU(UInt32 associativity, DramCacheReplPolicy* repl_policy);
 		virtual ~CacheSetInfoPageLRU();
 		void increment(UInt32 index) {
 			++m_access[index];
 		}
 
+		/* shared by all sets, state is m_lru_bits of each set */
+		DramCacheReplPolicy* m_repl_policy;
+
 	private:
 		const UInt32 m_associativity;
 		UInt64* m_access;
@@ -26,7 +30,7 @@ class CacheSetPageLRU : public CacheSet
 {
 	public:
 		CacheSetPageLRU(UInt32 associativity, UInt32 blocksize, 
-				CacheSetInfoPageLRU* set_info);
+				CacheSetInfoPageLRU* set_info, UInt32 set_index);
 		virtual ~CacheSetPageLRU();
 
 		virtual UInt32 getReplacementIndex(CacheCntlr*);
@@ -50,7 +54,7 @@ class CacheSetPageLRU : public CacheSet
 	protected:
 		UInt8* m_lru_bits;
 		CacheSetInfoPageLRU* m_set_info;
-		void moveToMRU(UInt32 accessed_index);
+		UInt32 m_set_index;
 };
 
 #endif
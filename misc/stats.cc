@@ -272,9 +272,9 @@ StatsManager::init()
 
    /* Initialize remap interval*/
 	// EXP_SET
-   int remap_interval_us = Sim()->getCfg()->getInt("perf_model/remap_config/remap_interval");
-   RemapInterval = SubsecondTime::US(remap_interval_us);
-   do_remap = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/remap", false);
+   StackedDramConfig* stacked_config = StackedDramConfig::getSingleton();
+   RemapInterval = SubsecondTime::US(stacked_config->remap_interval);
+   do_remap = stacked_config->remap;
    reverse_flp = Sim()->getCfg()->getBoolDefault("perf_model/thermal/reverse", false);
 
    /* Initialization of frequency table for DVFS*/
@@ -1137,7 +1137,7 @@ StatsManager::callHotSpot()
 			 */
 			double vault_temp = unit_temp[40 + v_i],
 				bank_temp = unit_temp[i];
-			m_stacked_dram_unison->updateTemperature(v_i, b_i, bank_temp, vault_temp);
+			m_stacked_dram_unison->updateTemperature(v_i, b_i, bank_temp, vault_temp, m_current_time);
 			if (prev_bank_temp[v_i][b_i] > 85) {
 				hot_access[v_i][b_i] += tmp->reads + tmp->writes;
 				if (prev_bank_temp[v_i][b_i] > 95) {
@@ -0,0 +1,92 @@
+#ifndef __ASSOC_LRU_TABLE_H__
+#define __ASSOC_LRU_TABLE_H__
+
+#include "fixed_types.h"
+
+#include <vector>
+
+/*
+ * Set-associative table with LRU replacement
+ *   Shared by the small on-die tables of the DRAM caches (footprint history
+ *   table, tag cache). The caller gives the key a hash, which picks the set;
+ *   the key itself is compared within the set.
+ */
+template <typename Key, typename Value>
+class AssocLruTable {
+	public:
+		AssocLruTable(UInt32 n_entries, UInt32 associativity)
+			: m_associativity(associativity > 0 ? associativity : 1),
+			  m_stamp(0)
+		{
+			m_set_num = n_entries / m_associativity;
+			if (m_set_num == 0)
+				m_set_num = 1;
+			m_entries.resize(m_set_num * m_associativity);
+			for (UInt32 i = 0; i < m_entries.size(); i++) {
+				m_entries[i].key = Key();
+				m_entries[i].value = Value();
+				m_entries[i].lru = 0;
+				m_entries[i].valid = false;
+			}
+		}
+
+		/* Returns the value of 'key' and makes it the most recently used, NULL if it is not in the table */
+		Value* lookup(const Key& key, UInt64 hash)
+		{
+			UInt32 base = getSet(hash) * m_associativity;
+			for (UInt32 i = base; i < base + m_associativity; i++) {
+				Entry& e = m_entries[i];
+				if (e.valid && e.key == key) {
+					e.lru = ++m_stamp;
+					return &e.value;
+				}
+			}
+			return NULL;
+		}
+
+		/* Sets the value of 'key', replacing the least recently used entry of its set if needed */
+		void insert(const Key& key, UInt64 hash, const Value& value)
+		{
+			UInt32 base = getSet(hash) * m_associativity;
+			UInt32 victim = base;
+			for (UInt32 i = base; i < base + m_associativity; i++) {
+				Entry& e = m_entries[i];
+				if (e.valid && e.key == key) {
+					victim = i;
+					break;
+				}
+				if (!e.valid) {
+					victim = i;
+				} else if (m_entries[victim].valid && e.lru < m_entries[victim].lru) {
+					victim = i;
+				}
+			}
+			Entry& e = m_entries[victim];
+			e.key = key;
+			e.value = value;
+			e.lru = ++m_stamp;
+			e.valid = true;
+		}
+
+	private:
+		struct Entry {
+			Key key;
+			Value value;
+			UInt64 lru;
+			bool valid;
+		};
+
+		UInt32 m_set_num;
+		UInt32 m_associativity;
+		std::vector<Entry> m_entries;
+		UInt64 m_stamp;
+
+		UInt32 getSet(UInt64 hash) const
+		{
+			/* mix the high bits in, so that neighbouring keys spread over sets */
+			UInt64 h = hash * 0x9E3779B97F4A7C15ULL;
+			return (h >> 32) % m_set_num;
+		}
+};
+
+#endif /* __ASSOC_LRU_TABLE_H__ */
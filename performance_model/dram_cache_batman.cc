@@ -0,0 +1,89 @@
+#include "dram_cache_batman.h"
+
+const double DramCacheBandwidthBalancer::OffchipSaturation = 0.9;
+
+DramCacheBandwidthBalancer::DramCacheBandwidthBalancer(double target_hit_rate, UInt32 epoch,
+		double latency_threshold, UInt32 unloaded_latency, float offchip_bandwidth)
+	: bypassed_hits(0),
+	  stacked_bytes(0), offchip_bytes(0),
+	  epochs(0), saturated_epochs(0),
+	  m_target_hit_rate(target_hit_rate),
+	  m_epoch(epoch > 0 ? epoch : 1),
+	  m_latency_threshold(latency_threshold),
+	  m_unloaded_latency(unloaded_latency > 0 ? unloaded_latency : 1),
+	  m_offchip_bandwidth(offchip_bandwidth),
+	  m_level(0),
+	  m_credit(0),
+	  m_epoch_accesses(0), m_epoch_hits(0),
+	  m_epoch_offchip(0),
+	  m_epoch_start(SubsecondTime::Zero()),
+	  m_last_reads(0),
+	  m_last_read_latency(0)
+{
+}
+
+DramCacheBandwidthBalancer::~DramCacheBandwidthBalancer()
+{
+}
+
+bool
+DramCacheBandwidthBalancer::bypassHit()
+{
+	// spread the bypassed hits evenly: m_level out of every MaxLevel hits
+	m_credit += m_level;
+	if (m_credit < MaxLevel)
+		return false;
+	m_credit -= MaxLevel;
+	bypassed_hits++;
+	return true;
+}
+
+bool
+DramCacheBandwidthBalancer::access(bool served_by_stacked)
+{
+	m_epoch_accesses++;
+	if (served_by_stacked)
+		m_epoch_hits++;
+	return m_epoch_accesses >= m_epoch;
+}
+
+void
+DramCacheBandwidthBalancer::endEpoch(SubsecondTime now, UInt64 n_reads, UInt64 tot_read_latency)
+{
+	epochs++;
+
+	/* Average latency of a stacked DRAM read during the epoch */
+	double read_latency = 0;
+	if (n_reads > m_last_reads) {
+		read_latency = (double)(tot_read_latency - m_last_read_latency)
+			/ (n_reads - m_last_reads);
+	}
+	bool stacked_saturated = read_latency > m_latency_threshold * m_unloaded_latency;
+
+	/* Utilization of the off-chip bandwidth during the epoch */
+	double offchip_util = 0;
+	if (now > m_epoch_start && m_offchip_bandwidth > 0) {
+		offchip_util = (double)m_epoch_offchip
+			/ ((now - m_epoch_start).getNS() * m_offchip_bandwidth);
+	}
+	bool offchip_saturated = offchip_util > OffchipSaturation;
+
+	double hit_rate = (double)m_epoch_hits / m_epoch_accesses;
+	if (stacked_saturated) {
+		saturated_epochs++;
+		if (hit_rate > m_target_hit_rate && !offchip_saturated) {
+			if (m_level < MaxLevel)
+				m_level++;
+		} else if (m_level > 0) {
+			m_level--;
+		}
+	} else if (m_level > 0) {
+		m_level--;
+	}
+
+	m_epoch_accesses = m_epoch_hits = 0;
+	m_epoch_offchip = 0;
+	m_epoch_start = now;
+	m_last_reads = n_reads;
+	m_last_read_latency = tot_read_latency;
+}
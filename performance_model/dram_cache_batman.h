@@ -0,0 +1,70 @@
+#ifndef __DRAM_CACHE_BATMAN_H__
+#define __DRAM_CACHE_BATMAN_H__
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+/*
+ * Bandwidth-aware hit steering (BATMAN) of the Unison cache
+ *   When the stacked DRAM queues are saturated, serving every hit from the
+ *   cache leaves the off-chip bandwidth idle. The balancer steers a fraction
+ *   of the clean read hits to off-chip memory, so that the fraction of
+ *   requests served by the cache converges to the target hit rate.
+ *   The bypass fraction is adjusted once per epoch of accesses, in steps of
+ *   1 / MaxLevel, and never grows while off-chip memory is itself saturated.
+ *   The stacked DRAM is accessed closed-loop, so its queues hardly ever hold
+ *   more than one request: saturation is detected from the average read
+ *   latency of the epoch instead, which grows with the bank conflicts,
+ *   refreshes and migration traffic the demand reads wait behind.
+ */
+class DramCacheBandwidthBalancer {
+	public:
+		static const UInt32 MaxLevel = 64;
+		/* off-chip utilization above which no more hits are steered */
+		static const double OffchipSaturation;
+
+		/* latency_threshold: saturation when the average read latency of an
+		 *   epoch exceeds latency_threshold * unloaded_latency
+		 * unloaded_latency: DRAM cycles of a read to a closed bank */
+		DramCacheBandwidthBalancer(double target_hit_rate, UInt32 epoch,
+				double latency_threshold, UInt32 unloaded_latency, float offchip_bandwidth);
+		~DramCacheBandwidthBalancer();
+
+		/* Called for every clean read hit, true if it is served off-chip */
+		bool bypassHit();
+
+		/* Bytes delivered by each memory for the current request */
+		void recordStacked(UInt32 bytes) { stacked_bytes += bytes; }
+		void recordOffchip(UInt32 bytes) { offchip_bytes += bytes; m_epoch_offchip += bytes; }
+
+		/* Called once per cache access, true when the access closes an epoch */
+		bool access(bool served_by_stacked);
+		/* Adjust the bypass fraction at the end of an epoch, with the cumulative
+		 * number of stacked DRAM reads and their latency in DRAM cycles */
+		void endEpoch(SubsecondTime now, UInt64 n_reads, UInt64 tot_read_latency);
+
+		UInt32 getLevel() const { return m_level; }
+
+		/* Statistics */
+		UInt64 bypassed_hits;
+		UInt64 stacked_bytes, offchip_bytes;
+		UInt64 epochs, saturated_epochs;
+
+	private:
+		const double m_target_hit_rate;
+		const UInt32 m_epoch;
+		const double m_latency_threshold;
+		const UInt32 m_unloaded_latency;
+		const float m_offchip_bandwidth;	// GB/s, i.e. bytes per ns
+
+		UInt32 m_level;	// bypass fraction = m_level / MaxLevel
+		UInt32 m_credit;
+
+		UInt32 m_epoch_accesses, m_epoch_hits;
+		UInt64 m_epoch_offchip;
+		SubsecondTime m_epoch_start;
+		UInt64 m_last_reads;
+		UInt64 m_last_read_latency;
+};
+
+#endif /* __DRAM_CACHE_BATMAN_H__ */
@@ -0,0 +1,115 @@
+#include "dram_cache_page_table.h"
+
+#include <cstring>
+
+PageAllocPolicy*
+PageAllocPolicy::create(policy_t policy, UInt32 n_colors)
+{
+	switch (policy) {
+		case RANDOM:
+			return new PageAllocRandom();
+		case COLOR:
+			return new PageAllocColor(n_colors > 0 ? n_colors : 1);
+		default:
+			return new PageAllocSequential();
+	}
+}
+
+PageAllocPolicy::policy_t
+PageAllocPolicy::parse(const char* name)
+{
+	if (strcmp(name, "random") == 0)
+		return RANDOM;
+	if (strcmp(name, "color") == 0)
+		return COLOR;
+	return SEQUENTIAL;
+}
+
+IntPtr
+PageAllocRandom::allocate(IntPtr v_tag)
+{
+	/* bijective mix of the page number inside its block of 2^bits pages:
+	 * odd multiplier and xorshift are both invertible modulo 2^bits */
+	UInt64 mask = (1ULL << m_bits) - 1;
+	UInt64 x = m_next & mask;
+	x = (x * 0x2545F491ULL) & mask;
+	x ^= x >> (m_bits / 2);
+	x = (x * 0x9E3779B1ULL + 0x7F4A7C15ULL) & mask;
+	IntPtr p_tag = (m_next & ~mask) | x;
+	m_next++;
+	return p_tag;
+}
+
+IntPtr
+PageAllocColor::allocate(IntPtr v_tag)
+{
+	UInt32 color = v_tag % m_n_colors;
+	return color + m_n_colors * (m_next[color]++);
+}
+
+DramCachePageTable::DramCachePageTable(PageAllocPolicy* policy, UInt32 init_capacity)
+	: m_policy(policy),
+	  m_size(0)
+{
+	m_capacity = 1;
+	while (m_capacity < init_capacity)
+		m_capacity <<= 1;
+	m_mask = m_capacity - 1;
+	m_keys = new IntPtr[m_capacity];
+	m_values = new IntPtr[m_capacity];
+	for (UInt64 i = 0; i < m_capacity; i++)
+		m_keys[i] = EMPTY;
+}
+
+DramCachePageTable::~DramCachePageTable()
+{
+	delete [] m_keys;
+	delete [] m_values;
+	delete m_policy;
+}
+
+IntPtr
+DramCachePageTable::translate(IntPtr v_tag)
+{
+	UInt64 i = (hash(v_tag) >> 16) & m_mask;
+	while (m_keys[i] != EMPTY) {
+		if (m_keys[i] == v_tag)
+			return m_values[i];
+		i = (i + 1) & m_mask;
+	}
+	/* first touch of this page */
+	IntPtr p_tag = m_policy->allocate(v_tag);
+	m_keys[i] = v_tag;
+	m_values[i] = p_tag;
+	m_size++;
+	if (m_size * 4 >= m_capacity * 3)
+		grow();
+	return p_tag;
+}
+
+void
+DramCachePageTable::grow()
+{
+	IntPtr* old_keys = m_keys;
+	IntPtr* old_values = m_values;
+	UInt64 old_capacity = m_capacity;
+
+	m_capacity <<= 1;
+	m_mask = m_capacity - 1;
+	m_keys = new IntPtr[m_capacity];
+	m_values = new IntPtr[m_capacity];
+	for (UInt64 i = 0; i < m_capacity; i++)
+		m_keys[i] = EMPTY;
+
+	for (UInt64 j = 0; j < old_capacity; j++) {
+		if (old_keys[j] == EMPTY)
+			continue;
+		UInt64 i = (hash(old_keys[j]) >> 16) & m_mask;
+		while (m_keys[i] != EMPTY)
+			i = (i + 1) & m_mask;
+		m_keys[i] = old_keys[j];
+		m_values[i] = old_values[j];
+	}
+	delete [] old_keys;
+	delete [] old_values;
+}
@@ -0,0 +1,87 @@
+#ifndef __DRAM_CACHE_PAGE_TABLE_H__
+#define __DRAM_CACHE_PAGE_TABLE_H__
+
+#include "fixed_types.h"
+
+#include <vector>
+
+/*
+ * Physical page allocation policies for the DRAM cache page table
+ *   sequential: physical pages in first-touch order (default)
+ *   random: a fixed pseudo-random permutation of the physical pages
+ *   color: a virtual page gets a physical page of the same color
+ *          (page number modulo the number of colors)
+ */
+class PageAllocPolicy {
+	public:
+		enum policy_t {
+			SEQUENTIAL = 0,
+			RANDOM,
+			COLOR,
+			NUM_POLICIES
+		};
+
+		virtual ~PageAllocPolicy() {}
+		/* Returns the physical page for a virtual page touched for the first time */
+		virtual IntPtr allocate(IntPtr v_tag) = 0;
+
+		static PageAllocPolicy* create(policy_t policy, UInt32 n_colors);
+		static policy_t parse(const char* name);
+};
+
+class PageAllocSequential : public PageAllocPolicy {
+	public:
+		PageAllocSequential() : m_next(0) {}
+		IntPtr allocate(IntPtr v_tag) { return m_next++; }
+	private:
+		IntPtr m_next;
+};
+
+class PageAllocRandom : public PageAllocPolicy {
+	public:
+		/* pages are permuted within blocks of 2^bits pages */
+		PageAllocRandom(UInt32 bits = 20) : m_next(0), m_bits(bits) {}
+		IntPtr allocate(IntPtr v_tag);
+	private:
+		IntPtr m_next;
+		UInt32 m_bits;
+};
+
+class PageAllocColor : public PageAllocPolicy {
+	public:
+		PageAllocColor(UInt32 n_colors) : m_next(n_colors, 0), m_n_colors(n_colors) {}
+		IntPtr allocate(IntPtr v_tag);
+	private:
+		std::vector<IntPtr> m_next;
+		UInt32 m_n_colors;
+};
+
+/*
+ * Virtual to physical page table of the DRAM cache
+ *   Open addressing with linear probing, keys and values live in two flat arrays
+ *   which are reallocated (doubled) when the table is 3/4 full.
+ *   translate() does the lookup and the allocation in a single probe sequence.
+ */
+class DramCachePageTable {
+	public:
+		DramCachePageTable(PageAllocPolicy* policy, UInt32 init_capacity = 1 << 16);
+		~DramCachePageTable();
+
+		IntPtr translate(IntPtr v_tag);
+		UInt64 size() const { return m_size; }
+
+	private:
+		static const IntPtr EMPTY = ~((IntPtr) 0);
+
+		PageAllocPolicy* m_policy;
+		IntPtr* m_keys;
+		IntPtr* m_values;
+		UInt64 m_capacity;
+		UInt64 m_mask;
+		UInt64 m_size;
+
+		static UInt64 hash(IntPtr key) { return (UInt64)key * 0x9E3779B97F4A7C15ULL; }
+		void grow();
+};
+
+#endif /* __DRAM_CACHE_PAGE_TABLE_H__ */
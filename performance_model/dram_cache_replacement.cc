@@ -0,0 +1,178 @@
+#include "dram_cache_replacement.h"
+#include "log.h"
+
+#include <cstring>
+
+DramCacheReplPolicy*
+DramCacheReplPolicy::create(policy_t policy, UInt32 associativity)
+{
+	switch (policy) {
+		case SRRIP:
+		case BRRIP:
+		case DRRIP:
+			return new DramCacheReplRRIP(associativity, policy);
+		case FOOTPRINT:
+			return new DramCacheReplFootprint(associativity);
+		default:
+			return new DramCacheReplLRU(associativity);
+	}
+}
+
+DramCacheReplPolicy::policy_t
+DramCacheReplPolicy::parse(const char* name)
+{
+	for (UInt32 i = 0; i < NUM_POLICIES; i++) {
+		if (strcmp(name, getName((policy_t)i)) == 0)
+			return (policy_t)i;
+	}
+	return LRU;
+}
+
+const char*
+DramCacheReplPolicy::getName(policy_t policy)
+{
+	switch (policy) {
+		case SRRIP: return "srrip";
+		case BRRIP: return "brrip";
+		case DRRIP: return "drrip";
+		case FOOTPRINT: return "footprint";
+		default: return "lru";
+	}
+}
+
+DramCacheReplPolicy::DramCacheReplPolicy(policy_t policy, UInt32 associativity)
+	: hits(0), misses(0), writebacks(0),
+	  m_policy(policy),
+	  m_associativity(associativity)
+{
+	/* the sets keep their per-way flags in arrays of MaxAssociativity */
+	LOG_ASSERT_ERROR(associativity > 0 && associativity <= MaxAssociativity,
+			"DRAM cache associativity %u is not in [1, %u]", associativity, MaxAssociativity);
+}
+
+UInt32
+DramCacheReplPolicy::findInvalid(const bool* valid) const
+{
+	for (UInt32 i = 0; i < m_associativity; i++) {
+		if (!valid[i])
+			return i;
+	}
+	return m_associativity;
+}
+
+/*
+   LRU
+   */
+UInt32
+DramCacheReplLRU::getVictim(UInt32 set_n, UInt8* state, const bool* valid, const UInt32* valid_blocks)
+{
+	misses++;
+	UInt32 index = findInvalid(valid);
+	if (index != m_associativity)
+		return index;
+
+	index = 0;
+	for (UInt32 i = 1; i < m_associativity; i++) {
+		if (state[i] > state[index])
+			index = i;
+	}
+	return index;
+}
+
+void
+DramCacheReplLRU::moveToMRU(UInt8* state, UInt32 way)
+{
+	UInt8 age = state[way];
+	for (UInt32 i = 0; i < m_associativity; i++) {
+		if (i != way && state[i] <= age && state[i] < 255)
+			state[i]++;
+	}
+	state[way] = 0;
+}
+
+/*
+   Footprint-aware
+   */
+UInt32
+DramCacheReplFootprint::getVictim(UInt32 set_n, UInt8* state, const bool* valid, const UInt32* valid_blocks)
+{
+	misses++;
+	UInt32 index = findInvalid(valid);
+	if (index != m_associativity)
+		return index;
+
+	index = 0;
+	UInt32 min_blocks = __builtin_popcount(valid_blocks[0]);
+	for (UInt32 i = 1; i < m_associativity; i++) {
+		UInt32 blocks = __builtin_popcount(valid_blocks[i]);
+		if (blocks < min_blocks || (blocks == min_blocks && state[i] > state[index])) {
+			min_blocks = blocks;
+			index = i;
+		}
+	}
+	return index;
+}
+
+/*
+   SRRIP / BRRIP / DRRIP
+   */
+DramCacheReplRRIP::DramCacheReplRRIP(UInt32 associativity, policy_t policy)
+	: DramCacheReplPolicy(policy, associativity),
+	  m_fills(0),
+	  m_psel(PselMax / 2)
+{
+}
+
+bool
+DramCacheReplRRIP::useBimodal(UInt32 set_n) const
+{
+	if (m_policy == SRRIP)
+		return false;
+	if (m_policy == BRRIP)
+		return true;
+	// DRRIP: leader sets follow a fixed policy, the others follow PSEL
+	UInt32 leader = set_n % DuelPeriod;
+	if (leader == 0)
+		return false;
+	if (leader == 1)
+		return true;
+	return m_psel > PselMax / 2;
+}
+
+UInt32
+DramCacheReplRRIP::getVictim(UInt32 set_n, UInt8* state, const bool* valid, const UInt32* valid_blocks)
+{
+	misses++;
+	if (m_policy == DRRIP) {
+		// a miss in a leader set votes against its policy
+		UInt32 leader = set_n % DuelPeriod;
+		if (leader == 0 && m_psel < PselMax)
+			m_psel++;
+		else if (leader == 1 && m_psel > 0)
+			m_psel--;
+	}
+
+	UInt32 index = findInvalid(valid);
+	if (index != m_associativity)
+		return index;
+
+	while (true) {
+		for (UInt32 i = 0; i < m_associativity; i++) {
+			if (state[i] >= MaxRRPV)
+				return i;
+		}
+		for (UInt32 i = 0; i < m_associativity; i++) {
+			state[i]++;
+		}
+	}
+}
+
+void
+DramCacheReplRRIP::onFill(UInt32 set_n, UInt8* state, UInt32 way)
+{
+	if (useBimodal(set_n)) {
+		state[way] = (++m_fills % BimodalPeriod == 0) ? MaxRRPV - 1 : MaxRRPV;
+	} else {
+		state[way] = MaxRRPV - 1;
+	}
+}
@@ -0,0 +1,100 @@
+#ifndef __DRAM_CACHE_REPLACEMENT_H__
+#define __DRAM_CACHE_REPLACEMENT_H__
+
+#include "fixed_types.h"
+
+/*
+ * Replacement policies of the page-based stacked DRAM caches
+ *   (DramCacheSetUnison and CacheSetPageLRU)
+ *   A set keeps one state byte per way (age or RRPV) and passes it in,
+ *   so a single policy object is shared by all sets of a cache.
+ *   Selected with perf_model/dram_cache/replacement:
+ *     lru, srrip, brrip, drrip, footprint
+ */
+class DramCacheReplPolicy {
+	public:
+		enum policy_t {
+			LRU = 0,
+			SRRIP,
+			BRRIP,
+			DRRIP,
+			FOOTPRINT,
+			NUM_POLICIES
+		};
+
+		/* upper bound of the associativity of the sets using a policy */
+		static const UInt32 MaxAssociativity = 64;
+
+		static DramCacheReplPolicy* create(policy_t policy, UInt32 associativity);
+		static policy_t parse(const char* name);
+		static const char* getName(policy_t policy);
+
+		DramCacheReplPolicy(policy_t policy, UInt32 associativity);
+		virtual ~DramCacheReplPolicy() {}
+
+		/* Choose the way to evict on a page miss, invalid ways first
+		 * valid_blocks: valid block bits of each way */
+		virtual UInt32 getVictim(UInt32 set_n, UInt8* state, const bool* valid, const UInt32* valid_blocks) = 0;
+		virtual void onHit(UInt32 set_n, UInt8* state, UInt32 way) = 0;
+		virtual void onFill(UInt32 set_n, UInt8* state, UInt32 way) = 0;
+
+		policy_t getPolicy() const { return m_policy; }
+
+		/* Statistics */
+		UInt64 hits, misses, writebacks;
+
+	protected:
+		const policy_t m_policy;
+		const UInt32 m_associativity;
+
+		UInt32 findInvalid(const bool* valid) const;
+};
+
+class DramCacheReplLRU : public DramCacheReplPolicy {
+	public:
+		DramCacheReplLRU(UInt32 associativity, policy_t policy = LRU)
+			: DramCacheReplPolicy(policy, associativity) {}
+
+		/* state: age, 0 is the most recently used */
+		UInt32 getVictim(UInt32 set_n, UInt8* state, const bool* valid, const UInt32* valid_blocks);
+		void onHit(UInt32 set_n, UInt8* state, UInt32 way) { hits++; moveToMRU(state, way); }
+		void onFill(UInt32 set_n, UInt8* state, UInt32 way) { moveToMRU(state, way); }
+
+	protected:
+		void moveToMRU(UInt8* state, UInt32 way);
+};
+
+/* Prefer evicting the page with the fewest valid blocks, LRU among equals */
+class DramCacheReplFootprint : public DramCacheReplLRU {
+	public:
+		DramCacheReplFootprint(UInt32 associativity)
+			: DramCacheReplLRU(associativity, FOOTPRINT) {}
+
+		UInt32 getVictim(UInt32 set_n, UInt8* state, const bool* valid, const UInt32* valid_blocks);
+};
+
+/* Re-reference interval prediction (Jaleel et al., ISCA 2010), 2-bit RRPV */
+class DramCacheReplRRIP : public DramCacheReplPolicy {
+	public:
+		static const UInt8 MaxRRPV = 3;
+		/* BRRIP inserts with a long (not distant) interval once every BimodalPeriod fills */
+		static const UInt32 BimodalPeriod = 32;
+		/* DRRIP set dueling */
+		static const UInt32 DuelPeriod = 32;
+		static const UInt32 PselMax = 1023;
+
+		DramCacheReplRRIP(UInt32 associativity, policy_t policy);
+
+		/* state: RRPV */
+		UInt32 getVictim(UInt32 set_n, UInt8* state, const bool* valid, const UInt32* valid_blocks);
+		void onHit(UInt32 set_n, UInt8* state, UInt32 way) { hits++; state[way] = 0; }
+		void onFill(UInt32 set_n, UInt8* state, UInt32 way);
+
+	private:
+		UInt32 m_fills;
+		UInt32 m_psel;
+
+		bool useBimodal(UInt32 set_n) const;
+};
+
+#endif /* __DRAM_CACHE_REPLACEMENT_H__ */
@@ -0,0 +1,26 @@
+#include "dram_cache_tag_cache.h"
+
+DramCacheTagCache::DramCacheTagCache(UInt32 n_entries, UInt32 associativity)
+	: lookups(0), predictions(0), correct(0), mispredictions(0),
+	  saved_requests(0),
+	  m_table(n_entries, associativity)
+{
+}
+
+bool
+DramCacheTagCache::lookup(UInt32 set_n, IntPtr tag, UInt32* way)
+{
+	lookups++;
+	UInt8* entry = m_table.lookup(std::make_pair(set_n, tag), (UInt64)tag ^ ((UInt64)set_n << 32));
+	if (entry == NULL)
+		return false;
+	*way = *entry;
+	predictions++;
+	return true;
+}
+
+void
+DramCacheTagCache::update(UInt32 set_n, IntPtr tag, UInt32 way)
+{
+	m_table.insert(std::make_pair(set_n, tag), (UInt64)tag ^ ((UInt64)set_n << 32), way);
+}
@@ -0,0 +1,34 @@
+#ifndef __DRAM_CACHE_TAG_CACHE_H__
+#define __DRAM_CACHE_TAG_CACHE_H__
+
+#include "fixed_types.h"
+#include "assoc_lru_table.h"
+
+#include <utility>
+
+/*
+ * On-die SRAM tag cache / way predictor of the Unison cache
+ *   Remembers the way of recently accessed (set, page tag) pairs,
+ *   so that a hit can go to the data without reading the tags in DRAM first.
+ *   Entries are not invalidated on eviction or remapping: a prediction is
+ *   verified against the set and a wrong one falls back to the tag read.
+ *   Set-associative, LRU replacement.
+ */
+class DramCacheTagCache {
+	public:
+		DramCacheTagCache(UInt32 n_entries, UInt32 associativity);
+
+		/* Returns true and the predicted way if (set_n, tag) is cached */
+		bool lookup(UInt32 set_n, IntPtr tag, UInt32* way);
+		void update(UInt32 set_n, IntPtr tag, UInt32 way);
+
+		/* Statistics */
+		UInt64 lookups, predictions, correct, mispredictions;
+		UInt64 saved_requests;
+
+	private:
+		/* (set, page tag) -> way */
+		AssocLruTable<std::pair<UInt32, IntPtr>, UInt8> m_table;
+};
+
+#endif /* __DRAM_CACHE_TAG_CACHE_H__ */
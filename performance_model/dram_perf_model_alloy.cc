@@ -87,12 +87,60 @@ DramCacheSetAlloy::accessAttempt(Core::mem_op_t type, IntPtr tag, IntPtr offset)
 	return res;
 }
 
+/*
+   AlloyMissPredictor class
+   */
+AlloyMissPredictor::AlloyMissPredictor(UInt32 n_cores)
+	: predictions(0), correct(0),
+	  parallel_issues(0),
+	  wasted_issues(0), wasted_bytes(0),
+	  m_n_cores(n_cores > 0 ? n_cores : 1)
+{
+	m_counters = new UInt8[m_n_cores];
+	for (UInt32 i = 0; i < m_n_cores; i++) {
+		// weakly predict hit
+		m_counters[i] = MissThreshold - 1;
+	}
+}
+
+AlloyMissPredictor::~AlloyMissPredictor()
+{
+	delete [] m_counters;
+}
+
+UInt8&
+AlloyMissPredictor::getCounter(core_id_t core)
+{
+	UInt32 c = (core >= 0) ? (UInt32)core % m_n_cores : 0;
+	return m_counters[c];
+}
+
+bool
+AlloyMissPredictor::predictMiss(core_id_t core)
+{
+	predictions++;
+	return getCounter(core) >= MissThreshold;
+}
+
+void
+AlloyMissPredictor::update(core_id_t core, bool miss)
+{
+	UInt8& counter = getCounter(core);
+	if (miss) {
+		if (counter < CounterMax)
+			counter++;
+	} else {
+		if (counter > 0)
+			counter--;
+	}
+}
+
 /*
    StackDramCacheCntlr class
    */
 StackDramCacheCntlrAlloy::StackDramCacheCntlrAlloy(
 		UInt32 set_num, UInt32 associativity, UInt32 blocksize)
-	: m_dram_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth")),
+	: m_dram_bandwidth(8 * StackedDramConfig::getSingleton()->per_controller_bandwidth),
 	  m_set_num(set_num),
 	  m_associativity(associativity),
 	  m_blocksize(blocksize)
@@ -118,6 +166,12 @@ StackDramCacheCntlrAlloy::StackDramCacheCntlrAlloy(
 
 	m_dram_perf_model = new StackedDramPerfAlloy(m_vault_num, m_vault_size, m_bank_size, m_row_size);
 	Sim()->getStatsManager()->init_stacked_dram_alloy(m_dram_perf_model);
+
+	m_miss_predictor = NULL;
+	StackedDramConfig* config = StackedDramConfig::getSingleton();
+	if (config->map_g) {
+		m_miss_predictor = new AlloyMissPredictor(Config::getSingleton()->getApplicationCores());
+	}
 }
 
 StackDramCacheCntlrAlloy::~StackDramCacheCntlrAlloy()
@@ -127,6 +181,13 @@ StackDramCacheCntlrAlloy::~StackDramCacheCntlrAlloy()
 	std::cout << "OUTPUT: DRAM Cache Stats: \n" 
 			  << "\t access: " << dram_stats.reads + dram_stats.writes << std::endl
 			  << "\t miss: " << dram_stats.misses << std::endl;
+	if (m_miss_predictor) {
+		std::cout << "\t MAP-G predictions: " << m_miss_predictor->predictions
+				  << ", correct: " << m_miss_predictor->correct
+				  << ", parallel issues: " << m_miss_predictor->parallel_issues
+				  << ", wasted off-chip bytes: " << m_miss_predictor->wasted_bytes << std::endl;
+		delete m_miss_predictor;
+	}
 
 	delete [] m_set_array;
 
@@ -134,7 +195,7 @@ StackDramCacheCntlrAlloy::~StackDramCacheCntlrAlloy()
 }
 
 SubsecondTime
-StackDramCacheCntlrAlloy::ProcessRequest(SubsecondTime pkt_time, DramCntlrInterface::access_t access_type, IntPtr address)
+StackDramCacheCntlrAlloy::ProcessRequest(SubsecondTime pkt_time, DramCntlrInterface::access_t access_type, IntPtr address, core_id_t requester)
 {
 	SubsecondTime model_delay = SubsecondTime::Zero();
 	SubsecondTime dram_delay = SubsecondTime::Zero();
@@ -157,12 +218,38 @@ StackDramCacheCntlrAlloy::ProcessRequest(SubsecondTime pkt_time, DramCntlrInterf
 	else
 		mem_op_type = Core::READ;
 
+	/* MAP-G: on a predicted miss the off-chip access starts together with the probe */
+	bool predicted_miss = false;
+	if (m_miss_predictor) {
+		predicted_miss = m_miss_predictor->predictMiss(requester);
+	}
+
 	UInt8 hit = m_set_array[set_n]->accessAttempt(mem_op_type, block_tag, block_offset);
 
 	// access tag need a read
 	// we put 28 TAD in one dram row
 	UInt32 row_i = set_n / 28;
-	dram_delay += m_dram_perf_model->getAccessLatency(pkt_time, 32, row_i, DramCntlrInterface::READ); 
+	SubsecondTime probe_delay = m_dram_perf_model->getAccessLatency(pkt_time, 32, row_i, DramCntlrInterface::READ); 
+
+	if (m_miss_predictor) {
+		if (predicted_miss == (hit == 0))
+			m_miss_predictor->correct++;
+		if (predicted_miss && hit != 0) {
+			// the parallel off-chip access was not needed
+			m_miss_predictor->wasted_issues++;
+			m_miss_predictor->wasted_bytes += OffchipFetchBytes;
+		}
+		m_miss_predictor->update(requester, hit == 0);
+	}
+
+	if (hit == 0 && predicted_miss) {
+		// off-chip fetch overlapped with the probe: the longer path counts
+		SubsecondTime offchip_delay = m_dram_bandwidth.getRoundedLatency(8 * OffchipFetchBytes);
+		dram_delay += (offchip_delay > probe_delay) ? offchip_delay : probe_delay;
+		m_miss_predictor->parallel_issues++;
+	} else {
+		dram_delay += probe_delay;
+	}
 
 	if (hit == 0) { // block is not in cache
 		m_set_array[set_n]->reads++;
@@ -176,7 +263,9 @@ StackDramCacheCntlrAlloy::ProcessRequest(SubsecondTime pkt_time, DramCntlrInterf
 
 		dram_delay += m_dram_perf_model->getAccessLatency(pkt_time, 32, row_i, DramCntlrInterface::WRITE);
 
-		model_delay += m_dram_bandwidth.getRoundedLatency(8 * 2 * 1024);
+		// serialized off-chip access after the probe
+		if (!predicted_miss)
+			model_delay += m_dram_bandwidth.getRoundedLatency(8 * OffchipFetchBytes);
 	}
 
 
@@ -217,18 +306,16 @@ DramPerfModelAlloy::DramPerfModelAlloy(core_id_t core_id,
       UInt32 cache_block_size):
    DramPerfModel(core_id, cache_block_size),
    m_queue_model(NULL),
-   m_dram_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth")), // Convert bytes to bits
+   m_dram_bandwidth(8 * StackedDramConfig::getSingleton()->per_controller_bandwidth), // Convert bytes to bits
    m_total_queueing_delay(SubsecondTime::Zero()),
    m_total_access_latency(SubsecondTime::Zero())
 {
-   SubsecondTime dram_latency = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/latency"))); // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
-   SubsecondTime dram_latency_stddev = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/normal/standard_deviation")));
-
-   m_dram_access_cost = new NormalTimeDistribution(dram_latency, dram_latency_stddev);
+   StackedDramConfig* config = StackedDramConfig::getSingleton();
+   m_dram_access_cost = new NormalTimeDistribution(config->dram_latency, config->dram_latency_stddev);
 
-   if (Sim()->getCfg()->getBool("perf_model/dram/queue_model/enabled"))
+   if (config->queue_model)
    {
-      m_queue_model = QueueModel::create("dram-queue", core_id, Sim()->getCfg()->getString("perf_model/dram/queue_model/type"),
+      m_queue_model = QueueModel::create("dram-queue", core_id, config->queue_model_type,
                                          m_dram_bandwidth.getRoundedLatency(8 * cache_block_size)); // bytes to bits
    }
 
@@ -242,6 +329,15 @@ DramPerfModelAlloy::DramPerfModelAlloy(core_id_t core_id,
    std::cout << "StackedDramSize: " << StackedDramSize << " StackedBlockSize: " << StackedBlockSizeAlloy << std::endl;
    std::cout << StackedDramSize / StackedBlockSizeAlloy * 1024<< std::endl;
    m_dram_cache_cntlr = new StackDramCacheCntlrAlloy(StackedDramSize / StackedSetSize * 28, 1, StackedBlockSize);
+
+   AlloyMissPredictor* predictor = m_dram_cache_cntlr->m_miss_predictor;
+   if (predictor) {
+      registerStatsMetric("dram-cache", core_id, "map-g-predictions", &predictor->predictions);
+      registerStatsMetric("dram-cache", core_id, "map-g-correct", &predictor->correct);
+      registerStatsMetric("dram-cache", core_id, "map-g-parallel-issues", &predictor->parallel_issues);
+      registerStatsMetric("dram-cache", core_id, "map-g-wasted-issues", &predictor->wasted_issues);
+      registerStatsMetric("dram-cache", core_id, "map-g-wasted-bytes", &predictor->wasted_bytes);
+   }
 }
 
 DramPerfModelAlloy::~DramPerfModelAlloy()
@@ -259,7 +355,7 @@ SubsecondTime
 DramPerfModelAlloy::getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, core_id_t requester, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf)
 {
 	SubsecondTime model_delay = SubsecondTime::Zero();
-	model_delay = m_dram_cache_cntlr->ProcessRequest(pkt_time, access_type, address);
+	model_delay = m_dram_cache_cntlr->ProcessRequest(pkt_time, access_type, address, requester);
 
 	//printf("Alloy Model# pkt_time: %ld, address: %ld\n", pkt_time.getMS(), address);
 	
@@ -71,6 +71,37 @@ protected:
 	const UInt32 m_associativity;
 };
 
+/*
+ * MAP-G memory access predictor (Alloy cache)
+ *   One 3-bit saturating counter per core: the DRAM controller interface
+ *   does not carry the PC, so the per-PC table of MAP-I cannot be indexed.
+ *   When a miss is predicted the off-chip access is issued in parallel
+ *   with the stacked DRAM probe.
+ */
+class AlloyMissPredictor
+{
+public:
+	static const UInt8 CounterMax = 7;
+	static const UInt8 MissThreshold = 4;
+
+	AlloyMissPredictor(UInt32 n_cores);
+	~AlloyMissPredictor();
+
+	bool predictMiss(core_id_t core);
+	void update(core_id_t core, bool miss);
+
+	/* Statistics */
+	UInt64 predictions, correct;
+	UInt64 parallel_issues;	// misses served in parallel with the probe
+	UInt64 wasted_issues, wasted_bytes;	// off-chip accesses for a hit
+
+private:
+	UInt32 m_n_cores;
+	UInt8* m_counters;
+
+	UInt8& getCounter(core_id_t core);
+};
+
 class StackDramCacheCntlrAlloy
 {
 public:
@@ -95,11 +126,15 @@ public:
 	
 	//Performance model
 	StackedDramPerfAlloy* m_dram_perf_model;
+	AlloyMissPredictor* m_miss_predictor;	// NULL if disabled
 	
 	StackDramCacheCntlrAlloy(UInt32 set_num, UInt32 associativity, UInt32 blocksize);
 	~StackDramCacheCntlrAlloy();
 
-	SubsecondTime ProcessRequest(SubsecondTime pkt_time, DramCntlrInterface::access_t access_type, IntPtr address);
+	/* Bytes moved by an off-chip fetch */
+	static const UInt32 OffchipFetchBytes = 2 * 1024;
+
+	SubsecondTime ProcessRequest(SubsecondTime pkt_time, DramCntlrInterface::access_t access_type, IntPtr address, core_id_t requester);
 	bool SplitAddress(IntPtr address, UInt32 *set_n, IntPtr *block_tag, IntPtr *block_offset);
 	friend class DramPerfModelAlloy;
 };
@@ -12,7 +12,7 @@ DramPerfModelConstant::DramPerfModelConstant(core_id_t core_id,
       UInt32 cache_block_size):
    DramPerfModel(core_id, cache_block_size),
    m_queue_model(NULL),
-   m_dram_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth")), // Convert bytes to bits
+   m_dram_bandwidth(8 * StackedDramConfig::getSingleton()->per_controller_bandwidth), // Convert bytes to bits
    m_total_queueing_delay(SubsecondTime::Zero()),
    m_total_access_latency(SubsecondTime::Zero())
 {
@@ -37,11 +37,12 @@ DramPerfModelConstant::DramPerfModelConstant(core_id_t core_id,
 
 	/*-----------------------------*/
 
-   m_dram_access_cost = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/latency"))); // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
+   StackedDramConfig* config = StackedDramConfig::getSingleton();
+   m_dram_access_cost = config->dram_latency;
 
-   if (Sim()->getCfg()->getBool("perf_model/dram/queue_model/enabled"))
+   if (config->queue_model)
    {
-      m_queue_model = QueueModel::create("dram-queue", core_id, Sim()->getCfg()->getString("perf_model/dram/queue_model/type"),
+      m_queue_model = QueueModel::create("dram-queue", core_id, config->queue_model_type,
                                          m_dram_bandwidth.getRoundedLatency(8 * cache_block_size)); // bytes to bits
    }
 
@@ -9,210 +9,268 @@
 #include <fstream>
 
 /*
-   Dram Cache Page Info Class
+   DramCachePageChunk Class
+   ---page metadata of SetsPerChunk consecutive sets, stored
+   as parallel arrays indexed by (set_in_chunk * associativity + way)
    */
-
-
-DramCachePageInfo::DramCachePageInfo()
-{
-	m_tag = ~0;
-	m_cstate = CacheState::INVALID;
-	m_used = 0;
-	pc = 0;
-	offset = 0;
-
-	vbits_0 = ~0;
-	vbits_1 = ~0;
-	dbits_0 = 0;
-	dbits_1 = 0;
-
-	m_footprint = 0;
-}
-
-DramCachePageInfo::DramCachePageInfo(IntPtr tag, CacheState::cstate_t cstate)
-	: m_tag(tag),
-	  m_cstate(cstate),
-	  m_used(0)
-{}
-
-DramCachePageInfo::~DramCachePageInfo()
-{}
-
-UInt32
-DramCachePageInfo::invalidate()
+DramCachePageChunk::DramCachePageChunk(UInt32 associativity)
+	: m_associativity(associativity)
 {
-	UInt32 wb_blocks = 0;
-	while (dbits_0 > 0) {
-		if ((dbits_0 & 1) == 1)
-			wb_blocks++;
-		dbits_0 >>= 1;
-	}
-	m_tag = ~0;
-	m_cstate = CacheState::INVALID;
-	vbits_0 = ~0;
-	vbits_1 = ~0;
-	dbits_0 = 0;
-	dbits_1 = 0;
-	m_used = 0;
-	offset = 0;
-	m_footprint = 0;
-	return wb_blocks;
+	UInt32 n_pages = DramCacheSetInfoUnison::SetsPerChunk * m_associativity;
+
+	m_tags = new IntPtr[n_pages];
+	m_vbits = new UInt32[n_pages];
+	m_dbits = new UInt32[n_pages];
+	m_footprint = new UInt32[n_pages];
+	m_used = new UInt8[n_pages];
+	m_predicted = new UInt32[n_pages];
+	m_trigger = new UInt64[n_pages];
+
+	for (UInt32 i = 0; i < n_pages; i++) {
+		m_tags[i] = ~0;
+		m_vbits[i] = ~0;
+		m_dbits[i] = 0;
+		m_footprint[i] = 0;
+		m_used[i] = ~0;
+		m_predicted[i] = 0;
+		m_trigger[i] = 0;
+	}
 }
 
-void
-DramCachePageInfo::clone(DramCachePageInfo* cache_page_info)
+DramCachePageChunk::~DramCachePageChunk()
 {
-	m_tag = cache_page_info->getTag();
-	m_cstate = cache_page_info->getCState();
-	m_used = cache_page_info->getUsage();
+	delete [] m_tags;
+	delete [] m_vbits;
+	delete [] m_dbits;
+	delete [] m_footprint;
+	delete [] m_used;
+	delete [] m_predicted;
+	delete [] m_trigger;
 }
 
-bool
-DramCachePageInfo::updateUsage(UInt32 offset, UInt32 size)
+UInt32
+DramCachePageChunk::findTag(UInt32 base, IntPtr tag) const
 {
-	return true;
+	const IntPtr* tags = m_tags + base;
+	UInt32 i = 0;
+	/* Compare the tag against all ways at once */
+#if defined(__AVX2__) && defined(__x86_64__)
+	const __m256i key = _mm256_set1_epi64x(tag);
+	for (; i + 4 <= m_associativity; i += 4) {
+		__m256i cmp = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(tags + i)), key);
+		int mask = _mm256_movemask_pd(_mm256_castsi256_pd(cmp));
+		if (mask)
+			return i + __builtin_ctz(mask);
+	}
+#elif defined(__SSE4_1__) && defined(__x86_64__)
+	const __m128i key = _mm_set1_epi64x(tag);
+	for (; i + 2 <= m_associativity; i += 2) {
+		__m128i cmp = _mm_cmpeq_epi64(_mm_loadu_si128((const __m128i*)(tags + i)), key);
+		int mask = _mm_movemask_pd(_mm_castsi128_pd(cmp));
+		if (mask)
+			return i + __builtin_ctz(mask);
+	}
+#endif
+	for (; i < m_associativity; i++) {
+		if (tags[i] == tag)
+			return i;
+	}
+	return m_associativity;
 }
 
-bool
-DramCachePageInfo::updateUsage(UInt32 used)
+UInt32
+DramCachePageChunk::invalidatePage(UInt32 page)
 {
-	m_used = used;
-	return true;
+	UInt32 wb_blocks = __builtin_popcount(m_dbits[page]);
+	m_tags[page] = ~0;
+	m_vbits[page] = ~0;
+	m_dbits[page] = 0;
+	m_footprint[page] = 0;
+	m_used[page] = ~0;
+	m_predicted[page] = 0;
+	return wb_blocks;
 }
 
 bool
-DramCachePageInfo::accessBlock(Core::mem_op_t type, UInt32 block_num)
+DramCachePageChunk::accessBlock(UInt32 page, Core::mem_op_t type, UInt32 block_num)
 {
-	bool v0 = (vbits_0 >> (block_num - 1)) & 1,
-		 v1 = (vbits_1 >> (block_num - 1)) & 1,
-		 d0 = (dbits_0 >> (block_num - 1)) & 1,
-		 d1 = (dbits_1 >> (block_num - 1)) & 1;
+	bool v0 = (m_vbits[page] >> (block_num - 1)) & 1;
 
 	// set block valid anyway: load block if miss
-	vbits_0 = vbits_0 | (1UL << block_num);
+	m_vbits[page] |= (1UL << block_num);
 	// set block dirty if write operation
 	if (type == Core::WRITE) {
-		dbits_0 = dbits_0 | (1UL << block_num);
+		m_dbits[page] |= (1UL << block_num);
 	}
 	// set block footprint
-	m_footprint = m_footprint | (1UL << block_num);
-	if (v1 || d0 || d1) {};
+	m_footprint[page] |= (1UL << block_num);
 
-	if (v0) return true;
-	return false;
-}
-
-void
-DramCachePageInfo::loadBlocks(UInt32 footprint)
-{
-	m_footprint = 0;
-	vbits_0 = footprint;
+	return v0;
 }
 
 /*
    DramCacheSetInfoUnison Class
+   ---shared by all sets, a directory of page chunks
+   which are only allocated when one of their sets is first touched
    */
-DramCacheSetInfoUnison::DramCacheSetInfoUnison(UInt32 associativity)
-	: m_associativity(associativity)
+DramCacheSetInfoUnison::DramCacheSetInfoUnison(UInt32 associativity, UInt32 set_num, DramCacheReplPolicy* repl_policy)
+	: m_repl_policy(repl_policy),
+	  m_associativity(associativity),
+	  m_set_num(set_num)
 {
+	m_chunk_num = (m_set_num + SetsPerChunk - 1) / SetsPerChunk;
+	m_chunks = new DramCachePageChunk*[m_chunk_num];
+	for (UInt32 i = 0; i < m_chunk_num; i++) {
+		m_chunks[i] = NULL;
+	}
+	allocated_chunks = 0;
 }
 
 DramCacheSetInfoUnison::~DramCacheSetInfoUnison()
 {
+	for (UInt32 i = 0; i < m_chunk_num; i++) {
+		delete m_chunks[i];
+	}
+	delete [] m_chunks;
+	delete m_repl_policy;
+}
+
+DramCachePageChunk*
+DramCacheSetInfoUnison::getChunk(UInt32 set_index)
+{
+	UInt32 chunk_i = set_index / SetsPerChunk;
+	if (m_chunks[chunk_i] == NULL) {
+		m_chunks[chunk_i] = new DramCachePageChunk(m_associativity);
+		allocated_chunks++;
+	}
+	return m_chunks[chunk_i];
 }
 
 /* 
    DramCacheSetUnison class
    */
 DramCacheSetUnison::DramCacheSetUnison(UInt32 associativity, UInt32 blocksize, 
-				DramCacheSetInfoUnison* set_info)
+				DramCacheSetInfoUnison* set_info, UInt32 set_index)
 	: reads(0),
 	  writes(0),
+	  resident(false),
 	  m_set_info(set_info),
-	  m_associativity(associativity)
+	  m_associativity(associativity),
+	  m_set_index(set_index),
+	  m_base((set_index % DramCacheSetInfoUnison::SetsPerChunk) * associativity)
 {
-	m_lru_bits = new UInt8[m_associativity];
-	for (UInt32 i = 0; i < m_associativity; i++) {
-		m_lru_bits[i] = i;
-	}
-
-	m_cache_page_info_array = new DramCachePageInfo*[m_associativity];
-	for (UInt32 i = 0; i < m_associativity; i++) {
-		m_cache_page_info_array[i] = new DramCachePageInfo();
-	}
+	m_pages = m_set_info->getChunk(set_index);
 }
 
 DramCacheSetUnison::~DramCacheSetUnison()
 {
-	for (UInt32 i = 0; i < m_associativity; i++) {
-		delete m_cache_page_info_array[i];
-	}
-	delete [] m_lru_bits;
-	delete [] m_cache_page_info_array;
 }
 
 UInt32
 DramCacheSetUnison::getReplacementIndex()
 {
 	reads++;
-	UInt8 max_t = 0;
-	UInt32 index = 0;
+	/* replacement state and valid bits of a set are contiguous */
+	bool valid[DramCacheReplPolicy::MaxAssociativity];
 	for (UInt32 i = 0; i < m_associativity; i++) {
-		if (m_cache_page_info_array[i]->getUsage() > max_t) {
-			max_t = m_cache_page_info_array[i]->getUsage();
-			index = i;
-		}
+		valid[i] = (m_pages->m_tags[m_base + i] != ((IntPtr) ~0));
 	}
-	return index;
+	return m_set_info->m_repl_policy->getVictim(m_set_index, m_pages->m_used + m_base,
+			valid, m_pages->m_vbits + m_base);
 }
 
 UInt32
 DramCacheSetUnison::invalidateContent()
 {
-	//std::cout << "before invalidate content" << std::endl;
 	UInt32 wb_blocks = 0;
 	for (UInt32 i = 0; i < m_associativity; i++) {
-		wb_blocks += m_cache_page_info_array[i]->invalidate();
+		wb_blocks += m_pages->invalidatePage(m_base + i);
 	}
-	//std::cout << "end invalidate content" << std::endl;
 	return wb_blocks;
 }
 
+UInt32
+DramCacheSetUnison::invalidatePage(UInt32 index)
+{
+	return m_pages->invalidatePage(m_base + index);
+}
+
+UInt32
+DramCacheSetUnison::findWay(IntPtr tag)
+{
+	return m_pages->findTag(m_base, tag);
+}
+
+UInt32
+DramCacheSetUnison::getFootprint(UInt32 index)
+{
+	return m_pages->m_footprint[m_base + index];
+}
+
+UInt32
+DramCacheSetUnison::getPredicted(UInt32 index)
+{
+	return m_pages->m_predicted[m_base + index];
+}
+
+UInt64
+DramCacheSetUnison::getTrigger(UInt32 index)
+{
+	return m_pages->m_trigger[m_base + index];
+}
+
+bool
+DramCacheSetUnison::isValid(UInt32 index)
+{
+	return m_pages->m_tags[m_base + index] != ((IntPtr) ~0);
+}
+
+bool
+DramCacheSetUnison::isDirty(UInt32 index, UInt32 block_num)
+{
+	return (m_pages->m_dbits[m_base + index] >> block_num) & 1;
+}
+
 UInt32
 DramCacheSetUnison::getDirtyBlocks()
 {
+	const UInt32* dbits = m_pages->m_dbits + m_base;
 	UInt32 dirty_blocks = 0;
 	for (UInt32 i = 0; i < m_associativity; i++) {
-		UInt32 db = m_cache_page_info_array[i]->getDirtyBits();
-		while (db > 0) {
-			if ((db & 1) == 1) {
-				dirty_blocks ++;
-			}
-			db >>= 1;
-		}
+		dirty_blocks += __builtin_popcount(dbits[i]);
 	}
-	//std::cout << "after get valid blocks" << std::endl;
 	return dirty_blocks;
 }
 
 UInt32
 DramCacheSetUnison::getValidBlocks()
 {
-	//std::cout << "before get valid blocks" << std::endl;
+	const UInt32* vbits = m_pages->m_vbits + m_base;
 	UInt32 valid_blocks = 0;
 	for (UInt32 i = 0; i < m_associativity; i++) {
-		UInt32 vb = m_cache_page_info_array[i]->getValidBits();
-		while (vb > 0) {
-			if ((vb & 1) == 1) {
-				valid_blocks ++;
-			}
-			vb >>= 1;
-		}
+		valid_blocks += __builtin_popcount(vbits[i]);
 	}
-	//std::cout << "after get valid blocks" << std::endl;
 	return valid_blocks;
 }
 
+UInt32
+DramCacheSetUnison::dropCleanBlocks()
+{
+	UInt32 dirty_blocks = 0;
+	for (UInt32 i = 0; i < m_associativity; i++) {
+		UInt32 page = m_base + i;
+		if (m_pages->m_tags[page] == ((IntPtr) ~0))
+			continue;
+		if (m_pages->m_dbits[page] == 0) {
+			m_pages->invalidatePage(page);
+		} else {
+			m_pages->m_vbits[page] &= m_pages->m_dbits[page];
+			dirty_blocks += __builtin_popcount(m_pages->m_dbits[page]);
+		}
+	}
+	return dirty_blocks;
+}
+
 void
 DramCacheSetUnison::updateReplacementIndex(UInt32 index)
 {
@@ -222,12 +280,16 @@ void
 DramCacheSetUnison::updateReplacementIndexTag(UInt32 index, IntPtr tag, IntPtr pc, 
 		IntPtr offset, UInt32 footprint)
 {
-	DramCachePageInfo *page = m_cache_page_info_array[index];
+	UInt32 page = m_base + index;
+	UInt32 block_num = offset / StackedBlockSize;
 	// here we simulate the replacement process
-	page->setTag(tag);
-	page->setValidBits(footprint);
-	page->setDirtyBits(0);
-	page->setFootprint(0);
+	// ---the predicted footprint and the demanded block are fetched
+	m_pages->m_tags[page] = tag;
+	m_pages->m_vbits[page] = footprint | (1UL << block_num);
+	m_pages->m_dbits[page] = 0;
+	m_pages->m_footprint[page] = (1UL << block_num);
+	m_pages->m_predicted[page] = m_pages->m_vbits[page];
+	m_pages->m_trigger[page] = FootprintHistoryTable::getKey(pc, block_num);
 
 	//increase the stats
 	//reads++
@@ -239,53 +301,47 @@ DramCacheSetUnison::updateReplacementIndexTag(UInt32 index, IntPtr tag, IntPtr p
 void
 DramCacheSetUnison::updateUsedInfo(IntPtr tag)
 {
-	UInt32 index = m_associativity;
-	for (UInt32 i = 0; i < m_associativity; i++) {
-		if (m_cache_page_info_array[i]->getTag() == tag) {
-			index = i;
-			break;
-		}
-	}
+	UInt32 index = m_pages->findTag(m_base, tag);
 	if (index == m_associativity) {
 		std::cout << "ERROR: update tag" << std::endl;
 		return;
-	} else {
-		if (m_cache_page_info_array[index]->getUsage() != 0) {
-			for (UInt32 i = 0; i < m_associativity; i++) {
-				if (index == i) {
-					m_cache_page_info_array[i]->updateUsage(0);
-				} else {
-					UInt8 tmp = m_cache_page_info_array[i]->getUsage();
-					m_cache_page_info_array[i]->updateUsage(tmp + 1);
-				}
-			}
-		}
 	}
+	m_set_info->m_repl_policy->onFill(m_set_index, m_pages->m_used + m_base, index);
+}
+
+void
+DramCacheSetUnison::movePage(UInt32 index, DramCacheSetUnison* src, UInt32 src_index)
+{
+	UInt32 page = m_base + index, src_page = src->m_base + src_index;
+	DramCachePageChunk* src_pages = src->m_pages;
+	m_pages->m_tags[page] = src_pages->m_tags[src_page];
+	m_pages->m_vbits[page] = src_pages->m_vbits[src_page];
+	m_pages->m_dbits[page] = src_pages->m_dbits[src_page];
+	m_pages->m_footprint[page] = src_pages->m_footprint[src_page];
+	m_pages->m_predicted[page] = src_pages->m_predicted[src_page];
+	m_pages->m_trigger[page] = src_pages->m_trigger[src_page];
+
+	writes++;
+	m_set_info->m_repl_policy->onFill(m_set_index, m_pages->m_used + m_base, index);
 }
 
 UInt8
 DramCacheSetUnison::accessAttempt(Core::mem_op_t type, IntPtr tag, IntPtr offset)
 {
-	UInt8 res = 0;
 	UInt32 block_num = offset / StackedBlockSize;
 	// here we simulate the looking up process
 	reads++;
-	for (UInt32 i = 0; i < m_associativity; i++) {
-		DramCachePageInfo *page = m_cache_page_info_array[i];
-		if (page->getTag() == tag) {
-
-			if (page->accessBlock(type, block_num)) {
-				
-				res = 2;
-			} else {
-				res = 1;
-				// reload block
-				writes++;
-			}
-			break;
-		}
+	UInt32 index = m_pages->findTag(m_base, tag);
+	if (index == m_associativity) {
+		return 0;
 	}
-	return res;
+	m_set_info->m_repl_policy->onHit(m_set_index, m_pages->m_used + m_base, index);
+	if (m_pages->accessBlock(m_base + index, type, block_num)) {
+		return 2;
+	}
+	// reload block
+	writes++;
+	return 1;
 }
 
 /*
@@ -293,38 +349,30 @@ DramCacheSetUnison::accessAttempt(Core::mem_op_t type, IntPtr tag, IntPtr offset
    */
 StackDramCacheCntlrUnison::StackDramCacheCntlrUnison(
 		UInt32 set_num, UInt32 associativity, UInt32 blocksize, UInt32 pagesize)
-      : m_dram_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth")), // Convert bytes to bits
+      : m_dram_bandwidth(8 * StackedDramConfig::getSingleton()->per_controller_bandwidth), // Convert bytes to bits
 	  m_set_num(set_num),
 	  m_associativity(associativity),
 	  m_blocksize(blocksize),
 	  m_pagesize(pagesize)
 {
+	m_config = StackedDramConfig::getSingleton();
 	log_file.open("unison_addr.txt");
 
 	std::cout << "Normal Cache Total set: " << set_num << std::endl;
-	m_set_info = new DramCacheSetInfoUnison(m_associativity);
+	m_set_info = new DramCacheSetInfoUnison(m_associativity, m_set_num, 
+			DramCacheReplPolicy::create((DramCacheReplPolicy::policy_t)m_config->replacement, m_associativity));
 
 	// Initialize the set array
+	// ---sets are only created when they are first touched (see getSet)
 	m_set = new DramCacheSetUnison*[m_set_num];
-	// Initialize the thermal valid array
-	// ---indicate whether we can access a specific set
-	m_set_thermal_valid = new bool[m_set_num];
-	for (int i = 0; i < m_set_num; i++) {
-		m_set_thermal_valid[i] = true;
-	}
-
-	for (UInt32 i = 0; i < 31; i++) {
-		FHT[i] = 0;
-	}
-
 	for (UInt32 i = 0; i < m_set_num; i++) {
-		UInt32 offset = i >> 12;
-		UInt32 vault_mask = (1ull << 5) - 1;
-		m_set[i] = new DramCacheSetUnison(m_associativity, m_blocksize, m_set_info);
+		m_set[i] = NULL;
+	}
 
-		m_set[i]->n_vault = offset & vault_mask;
-		m_set[i]->n_bank = (i >> 11) & 1;
-		m_set[i]->n_level = (offset >> 5) & 3;
+	m_fht = new FootprintHistoryTable(m_config->fht_entries, m_config->fht_assoc);
+	m_tag_cache = NULL;
+	if (m_config->tag_cache) {
+		m_tag_cache = new DramCacheTagCache(m_config->tag_cache_entries, m_config->tag_cache_assoc);
 	}
 
 	for (UInt32 i = 0; i < 32; i++) {
@@ -335,7 +383,7 @@ StackDramCacheCntlrUnison::StackDramCacheCntlrUnison(
 
 	// Initialize dram performance model
 	// we have 32 vaults, 1 vault = 128 mb, 1 bank = 16 mb, 1 row = 8 kb
-	UInt32 cache_size = Sim()->getCfg()->getInt("perf_model/dram_cache/cache_size");
+	UInt32 cache_size = m_config->cache_size;
 	cache_size *= 1024;
 
 	m_vault_num = 32;
@@ -348,16 +396,26 @@ StackDramCacheCntlrUnison::StackDramCacheCntlrUnison(
 	page_disabled = 0;
 	// Statistics for simulating remapping
 	invalid_times = invalid_blocks = migrate_times = migrate_blocks = 0;
+	swap_sets = swap_blocks = 0;
+	transit_sets = demand_transit_sets = demand_transit_blocks = 0;
+	moved_pages = 0;
 	// Choose Invalidation/Migration mechanism
 	remap_invalid = true;
 
 
 	m_dram_perf_model = new StackedDramPerfUnison(m_vault_num, m_vault_size, m_bank_size, m_row_size);
+	m_bank_sets.resize(m_vault_num * m_dram_perf_model->n_banks);
+
+	m_batman = NULL;
+	if (m_config->batman) {
+		RamSpec* spec = m_dram_perf_model->m_dram_model->spec;
+		m_batman = new DramCacheBandwidthBalancer(m_config->batman_target_hit_rate, m_config->batman_epoch,
+				m_config->batman_latency_threshold, spec->speed_entry.nRCDR + spec->read_latency,
+				m_config->per_controller_bandwidth);
+	}
 
 
-   SubsecondTime dram_latency = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/latency"))); // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
-   SubsecondTime dram_latency_stddev = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/normal/standard_deviation")));
-   m_dram_access_cost = new NormalTimeDistribution(dram_latency, dram_latency_stddev);
+   m_dram_access_cost = new NormalTimeDistribution(m_config->dram_latency, m_config->dram_latency_stddev);
 	/*
 	   Initial DRAM stats
 	 */
@@ -366,7 +424,8 @@ StackDramCacheCntlrUnison::StackDramCacheCntlrUnison(
 	/*
 	   Initial Page Table
 	*/
-	avail_phy_page_tag = 0;
+	page_table = new DramCachePageTable(PageAllocPolicy::create(
+				(PageAllocPolicy::policy_t)m_config->page_alloc, m_config->page_colors));
 
 }
 
@@ -385,7 +444,9 @@ StackDramCacheCntlrUnison::~StackDramCacheCntlrUnison()
 		miss_rate_roi = (float)tot_miss_roi / (float)cache_access_roi;
 
 	std::cout << "\n ***** [DRAM_CACHE_Result] *****\n\n";
-	std::cout << "Number of memory pages: " << page_table.size() << std::endl;
+	std::cout << "Number of memory pages: " << page_table->size() << std::endl;
+	std::cout << "Touched sets: " << m_touched_sets.size() << " of " << m_set_num
+			  << ", metadata chunks: " << m_set_info->allocated_chunks << std::endl;
 	std::cout << "*** DRAM Total Access: " << cache_access
 			  << ", page disabled: " << page_disabled
 			  << ", page miss: " << page_misses << ", block misses: " << block_misses
@@ -397,7 +458,11 @@ StackDramCacheCntlrUnison::~StackDramCacheCntlrUnison()
 			  << std::endl;
 	std::cout << "*** DRAM Remap Times: " 
 			  << invalid_times << " invalid times, " << invalid_blocks << " total invalid_blocks, "
-			  << migrate_times << " migrate times, " << migrate_blocks << " total migrate blocks."
+			  << migrate_times << " migrate times, " << migrate_blocks << " total migrate blocks, "
+			  << swap_sets << " swapped sets, " << swap_blocks << " total swap blocks, "
+			  << transit_sets << " sets in transit, " << demand_transit_sets << " finished on demand ("
+			  << demand_transit_blocks << " blocks), "
+			  << moved_pages << " pages moved to the remapped sets."
 			  << std::endl;
 	std::cout << "*** DRAM Statistics: " 
 			  << m_dram_perf_model->tot_dram_reads << " reads, "
@@ -408,18 +473,62 @@ StackDramCacheCntlrUnison::~StackDramCacheCntlrUnison()
 			  << m_dram_perf_model->tot_rd_t.getUS() << " RD time, "
 			  << m_dram_perf_model->tot_wr_t.getUS() << " WR time."
 			  << std::endl;
+	if (m_tag_cache) {
+		float accuracy = 0;
+		if (m_tag_cache->predictions != 0)
+			accuracy = (float)m_tag_cache->correct / (float)m_tag_cache->predictions;
+		std::cout << "*** Tag Cache: " << m_tag_cache->lookups << " lookups, "
+				  << m_tag_cache->predictions << " predictions, "
+				  << "accuracy: " << accuracy << ", "
+				  << m_tag_cache->saved_requests << " saved tag reads."
+				  << std::endl;
+	}
+	if (m_batman) {
+		std::cout << "*** BATMAN: " << m_batman->bypassed_hits << " hits served off-chip, "
+				  << m_batman->stacked_bytes << " bytes from stacked DRAM, "
+				  << m_batman->offchip_bytes << " bytes from off-chip, "
+				  << m_batman->saturated_epochs << "/" << m_batman->epochs << " saturated epochs, "
+				  << "final bypass level: " << m_batman->getLevel() << "/" << DramCacheBandwidthBalancer::MaxLevel
+				  << std::endl;
+	}
 	std::cout << "\n ***** [DRAM_CACHE_Result] *****\n\n";
 
 	log_file.close();
+	for (UInt32 i = 0; i < m_touched_sets.size(); i++) {
+		delete m_set[m_touched_sets[i]];
+	}
 	delete m_set_info;
 	delete [] m_set;
+	delete m_fht;
+	if (m_tag_cache)
+		delete m_tag_cache;
+	if (m_batman)
+		delete m_batman;
+	delete page_table;
 
 	delete m_dram_perf_model;
    delete m_dram_access_cost;
 }
 
+DramCacheSetUnison*
+StackDramCacheCntlrUnison::getSet(UInt32 set_n)
+{
+	if (m_set[set_n] == NULL) {
+		UInt32 offset = set_n >> 12;
+		UInt32 vault_mask = (1ull << 5) - 1;
+		m_set[set_n] = new DramCacheSetUnison(m_associativity, m_blocksize, m_set_info, set_n);
+
+		m_set[set_n]->n_vault = offset & vault_mask;
+		m_set[set_n]->n_bank = (set_n >> 11) & 1;
+		m_set[set_n]->n_level = (offset >> 5) & 3;
+
+		m_touched_sets.push_back(set_n);
+	}
+	return m_set[set_n];
+}
+
 SubsecondTime
-StackDramCacheCntlrUnison::ProcessRequest(SubsecondTime pkt_time, UInt64 pkt_size, DramCntlrInterface::access_t access_type, IntPtr address, ShmemPerf *perf)
+StackDramCacheCntlrUnison::ProcessRequest(SubsecondTime pkt_time, UInt64 pkt_size, DramCntlrInterface::access_t access_type, IntPtr address, IntPtr pc, ShmemPerf *perf)
 {
 	SubsecondTime model_delay = SubsecondTime::Zero();
 	SubsecondTime dram_delay = SubsecondTime::Zero();
@@ -427,7 +536,6 @@ StackDramCacheCntlrUnison::ProcessRequest(SubsecondTime pkt_time, UInt64 pkt_siz
 	UInt32 set_n;
 	IntPtr page_tag;
 	IntPtr page_offset;
-	UInt64 pc = 0;
 	UInt32 footprint = 0;
 
 	/* Here we need to translate virtual address to physical adress
@@ -445,7 +553,6 @@ TODO:
 
 
 	UInt8 block_num = page_offset / m_blocksize;
-	footprint = FHT[block_num];
 
 	Core::mem_op_t mem_op_type;
 	if (access_type == DramCntlrInterface::WRITE) 
@@ -455,6 +562,9 @@ TODO:
 
 	/* Place to call remapping manager (REMAP_MAN) */
 	SubsecondTime remap_delay = checkRemapping(pkt_time, perf);
+	/* the first access to a row in transit moves what is left of it */
+	if (m_config->lazy_migration)
+		remap_delay += finishTransit(pkt_time + remap_delay, set_n, perf);
 
 	/*
 	 * Here we can calculate the new target set here 
@@ -474,15 +584,14 @@ TODO:
 	cache_access ++;
 	
 	SubsecondTime dram_access_cost = m_dram_access_cost->next();
-	int avg_queue_latency_ns = Sim()->getCfg()->getInt("perf_model/dram/avg_queue_latency");
-	SubsecondTime avg_queue_latency = SubsecondTime::NS(avg_queue_latency_ns);
+	SubsecondTime avg_queue_latency = m_config->avg_queue_latency;
 
 	SubsecondTime orig_dram_access_cost = dram_access_cost;
 
 	bool enable_remap = m_dram_perf_model->enable_remap;
-	int n_remap = Sim()->getCfg()->getInt("perf_model/remap_config/n_remap");
-	bool global_remap = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/inter_vault", false);
-	bool on_top = Sim()->getCfg()->getBoolDefault("perf_model/stacked_dram/on_top", true);
+	int n_remap = m_config->n_remap;
+	bool global_remap = m_config->inter_vault;
+	bool on_top = m_config->on_top;
 	if (enable_remap) {
 		if (n_remap == 1 && global_remap) {
 			dram_delay += SubsecondTime::PS(200);
@@ -492,7 +601,7 @@ TODO:
 	}
 
 	//std::cout << dram_access_cost.getNS() << " " << pkt_size << std::endl;
-	bool dram_disabled = Sim()->getCfg()->getBoolDefault("perf_model/stacked_dram/disabled", false);
+	bool dram_disabled = m_config->disabled;
 	bool set_disabled = m_dram_perf_model->checkSetDisabled(set_n);
 	if (set_disabled || dram_disabled) {
 		model_delay += m_dram_bandwidth.getRoundedLatency(8 * pkt_size);
@@ -503,6 +612,8 @@ TODO:
 
 		block_misses ++;
 		page_disabled ++;
+		if (m_batman)
+			m_batman->recordOffchip(pkt_size);
 
 		/**/
 		Sim()->getStatsManager()->updateCurrentTime(pkt_time + model_delay);
@@ -525,16 +636,31 @@ TODO:
 	   But the 'set_n' used in handleDramAccess must not be changed
 	   , which must be managed in Remapping code
 	 */
-	UInt8 hit = m_set[set_n]->accessAttempt(mem_op_type, page_tag, page_offset);
-
+	DramCacheSetUnison* set = getSet(set_n);
+
+	/* On-die tag cache: a correctly predicted way skips the tag read in DRAM */
+	bool skip_tag_read = false;
+	if (m_tag_cache) {
+		UInt32 way = 0;
+		if (m_tag_cache->lookup(set_n, page_tag, &way)) {
+			if (set->findWay(page_tag) == way) {
+				m_tag_cache->correct++;
+				skip_tag_read = true;
+			} else {
+				m_tag_cache->mispredictions++;
+			}
+		}
+	}
 
-	/*
-	   
-	*/
+	UInt8 hit = set->accessAttempt(mem_op_type, page_tag, page_offset);
 
 	// access tag need a read
 	//dram_delay += m_dram_perf_model->getAccessLatency(pkt_time, 64, set_n, DramCntlrInterface::READ); 
-	dram_delay += handleDramAccess(pkt_time, 64, set_n, DramCntlrInterface::READ, perf);
+	if (skip_tag_read) {
+		m_tag_cache->saved_requests += (64 / m_config->bandwidth > 0) ? 64 / m_config->bandwidth : 1;
+	} else {
+		dram_delay += handleDramAccess(pkt_time, 64, set_n, DramCntlrInterface::READ, perf);
+	}
 
 	/* Here we record how many load/write to main memory after cache */
 	UInt32 load_blocks = 0, writeback_blocks = 0;
@@ -542,8 +668,8 @@ TODO:
 	if (hit == 0) { // page is not in cache
 		page_misses ++;
 
-		m_set[set_n]->reads++;
-		UInt32 index = m_set[set_n]->getReplacementIndex();
+		set->reads++;
+		UInt32 index = set->getReplacementIndex();
 		// page eviction
 		/*
 		   1. alter page tag
@@ -552,24 +678,28 @@ TODO:
 		   4. update footprint history table
 		   */
 
-		// update footprint history table
-		UInt32 new_footprint = m_set[set_n]->m_cache_page_info_array[index]->getFootprint();
-		FHT[block_num] = new_footprint;
-		while (new_footprint > 0) {
-			if ((new_footprint & 1) == 1) {
-				load_blocks++;
-			}
-			new_footprint >>= 1;
+		// update footprint history table with the footprint of the evicted page
+		if (set->isValid(index)) {
+			UInt32 used = set->getFootprint(index);
+			m_fht->update(set->getTrigger(index), used);
+			m_fht->recordEviction(set->getPredicted(index), used);
+		}
+		// predict the footprint of the new page, only the demanded block on a FHT miss
+		if (!m_fht->lookup(FootprintHistoryTable::getKey(pc, block_num), &footprint)) {
+			footprint = 0;
 		}
+		load_blocks = __builtin_popcount(footprint | (1UL << block_num));
 		// page eviction & load new page
-		writeback_blocks = m_set[set_n]->m_cache_page_info_array[index]->invalidate();
+		writeback_blocks = set->invalidatePage(index);
+		m_set_info->m_repl_policy->writebacks += writeback_blocks;
 		wb_blocks += writeback_blocks;
 		ld_blocks += load_blocks;
 
 		load_on_page_miss += load_blocks;
 		write_on_page_miss += writeback_blocks;
 
-		m_set[set_n]->updateReplacementIndexTag(index, page_tag, pc, page_offset, footprint);
+		set->updateReplacementIndexTag(index, page_tag, pc, page_offset, footprint);
+		markResident(set_n, set);
 
 		/* Write Back Dirty Blocks*/
 		//dram_delay += m_dram_perf_model->getAccessLatency(pkt_time, 64 * writeback_blocks, set_n, DramCntlrInterface::WRITE); 
@@ -586,10 +716,21 @@ TODO:
 		load_blocks ++;
 	} 
 
+	if (m_tag_cache) {
+		m_tag_cache->update(set_n, page_tag, set->findWay(page_tag));
+	}
+
 	//dram_delay += m_dram_perf_model->getAccessLatency(pkt_time, 64, set_n, access_type); 
 
+	/* BATMAN: steer a fraction of the clean read hits off-chip when the stacked DRAM is saturated */
+	bool bypass = false;
+	if (m_batman && hit == 2 && mem_op_type == Core::READ
+			&& !set->isDirty(set->findWay(page_tag), block_num)) {
+		bypass = m_batman->bypassHit();
+	}
+
 	/* Here we update memory access delays*/
-	if (load_blocks > 0) {
+	if (load_blocks > 0 || bypass) {
 		mem_access_delay += m_dram_bandwidth.getRoundedLatency(8 * 64);
 		//mem_access_delay += m_dram_bandwidth.getRoundedLatency(8 * 64 * writeback_blocks);
 		model_delay += (dram_access_cost + avg_queue_latency);
@@ -597,6 +738,18 @@ TODO:
 		dram_delay += handleDramAccess(pkt_time, 64, set_n, access_type, perf); 
 	}
 
+	if (m_batman) {
+		if (load_blocks > 0 || bypass) {
+			m_batman->recordOffchip(64 * (load_blocks + writeback_blocks + (bypass ? 1 : 0)));
+		} else {
+			m_batman->recordStacked(64);
+		}
+		if (m_batman->access(hit == 2 && !bypass)) {
+			DramModel* dram_model = m_dram_perf_model->m_dram_model;
+			m_batman->endEpoch(pkt_time, dram_model->n_reads, dram_model->tot_read_latency);
+		}
+	}
+
 
 	UInt32 vault_bit = floorLog2(m_vault_num);
 	UInt32 bank_bit = floorLog2(m_vault_size / m_bank_size);
@@ -640,11 +793,7 @@ StackDramCacheCntlrUnison::checkRemapping(SubsecondTime pkt_time, ShmemPerf *per
 	/*Here we need to check:
 	 * 1. the temperature: high -> m_set_thermal_valid = false
 	 * 2. valid bit: invalid -> write back dirty blocks*/
-	UInt32 vault_bit = floorLog2(m_vault_num);
-	UInt32 bank_bit = floorLog2(m_vault_size / m_bank_size);
-	UInt32 row_bit = floorLog2(m_bank_size / m_row_size);
-	UInt32 row_num = (1 << row_bit);
-	UInt32 bank_num = (1 << bank_bit);
+	UInt32 bank_num = m_dram_perf_model->n_banks;
 	UInt32 vault_num = m_vault_num;
 
 
@@ -680,66 +829,105 @@ StackDramCacheCntlrUnison::checkRemapping(SubsecondTime pkt_time, ShmemPerf *per
 
 	//SubsecondTime dram_access_cost = m_dram_access_cost->next();
 
-	for (UInt32 vault_i = 0; vault_i < vault_num; vault_i++) {
-		for (UInt32 bank_i = 0; bank_i < bank_num; bank_i++) {
-			for (UInt32 row_i = 0; row_i < row_num; row_i++) {
-
-				//std::cout << "checking a set!" << cnt << "\n";
-				cnt++;
-
-				bool valid = m_dram_perf_model->checkRowValid(vault_i, bank_i, row_i),
-					 migrated = m_dram_perf_model->checkRowMigrated(vault_i, bank_i, row_i),
-					 disabled = m_dram_perf_model->checkRowDisabled(vault_i, bank_i, row_i);
-				if (valid && !migrated) continue;
-
-
-				UInt32 set_valid_blocks = 0, set_wb_blocks = 0;
-				UInt32 set_i = m_dram_perf_model->getSetNum(vault_i, bank_i, row_i);
-
-				set_wb_blocks = m_set[set_i]->getDirtyBlocks();
-				set_valid_blocks = m_set[set_i]->getValidBlocks();
+	/* Only the banks published by the remapping manager can hold invalid or migrated rows,
+	 * and only their resident sets hold data to write back or move */
+	const std::vector<UInt32>& changed_banks = m_dram_perf_model->getChangedBanks();
+	for (UInt32 c = 0; c < changed_banks.size(); c++) {
+		UInt32 bank_id = changed_banks[c];
+		UInt32 vault_i = bank_id / bank_num, bank_i = bank_id % bank_num;
+		std::vector<UInt32>& bank_sets = m_bank_sets[bank_id];
+		UInt32 n_kept = 0;
+
+		for (UInt32 k = 0; k < bank_sets.size(); k++) {
+			UInt32 set_i = bank_sets[k];
+			UInt32 v = 0, b = 0, row_i = 0;
+			m_dram_perf_model->splitSetNum(set_i, &v, &b, &row_i);
+
+			//std::cout << "checking a set!" << cnt << "\n";
+			cnt++;
+
+			bool valid = m_dram_perf_model->checkRowValid(vault_i, bank_i, row_i),
+				 migrated = m_dram_perf_model->checkRowMigrated(vault_i, bank_i, row_i),
+				 moved = m_dram_perf_model->checkRowMoved(vault_i, bank_i, row_i);
+			if (valid && !migrated && !moved) {
+				bank_sets[n_kept++] = set_i;
+				continue;
+			}
+			if (valid && moved) {
+				/* Swapped bank: the migration engine copies the dirty blocks in idle
+				 * DRAM cycles, without delaying this access, the clean ones are dropped */
+				DramCacheSetUnison* set = m_set[set_i];
+				UInt32 dirty_blocks = set->dropCleanBlocks();
+				m_dram_perf_model->migrateSet(set_i, dirty_blocks);
+				swap_sets ++;
+				swap_blocks += dirty_blocks;
+				if (dirty_blocks > 0)
+					bank_sets[n_kept++] = set_i;
+				else
+					set->resident = false;
+				continue;
+			}
 
-				invalid_cnt ++;
-				if (!valid) {
-					//std::cout << "invalid!\n";
+			UInt32 set_valid_blocks = 0, set_wb_blocks = 0;
+			DramCacheSetUnison* set = m_set[set_i];
+
+			set_wb_blocks = set->getDirtyBlocks();
+			set_valid_blocks = set->getValidBlocks();
+
+			invalid_cnt ++;
+			/* migrated rows belong to an invalid bank: check them first */
+			if (migrated) {
+				/* the accesses to the row go to the set of the bank it was combined with,
+				 * the dirty blocks of the pages the move evicts there are written back */
+				UInt32 remap_set_n = m_dram_perf_model->getRemapSet(set_i);
+				UInt32 evicted_wb_blocks = movePages(set_i);
+				writeback_blocks += evicted_wb_blocks;
+				if (m_config->lazy_migration) {
+					/* copied in idle DRAM cycles, or by the first access to the row */
+					m_dram_perf_model->startMigration(set_i, set_valid_blocks);
+					transit_sets ++;
+					if (evicted_wb_blocks > 0) {
+						m_dram_perf_model->startWriteback(remap_set_n, evicted_wb_blocks);
+						transit_sets ++;
+					}
+				} else {
+					/* Latency for migration */
+					cntlr_delay[vault_i] += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::READ, perf); 
+					cntlr_delay[vault_i] += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::WRITE, perf); 
+					/* Latency for the write back of the evicted pages, as an invalidation */
+					if (evicted_wb_blocks > 0) {
+						UInt32 remap_vault = 0, remap_bank = 0, remap_row = 0;
+						m_dram_perf_model->splitSetNum(remap_set_n, &remap_vault, &remap_bank, &remap_row);
+						cntlr_delay[remap_vault] += m_dram_bandwidth.getRoundedLatency(8 * 64 * evicted_wb_blocks);
+						cntlr_delay[remap_vault] += handleDramAccess(pkt_time, 8 * evicted_wb_blocks * 64, remap_set_n, DramCntlrInterface::READ, perf); 
+					}
+				}
+				migrate_times ++;
+				migrate_blocks += set_valid_blocks;
+			} else if (!valid) {
+				if (m_config->lazy_migration) {
+					/* written back in idle DRAM cycles, or by the first access to the row */
+					if (set_wb_blocks > 0) {
+						m_dram_perf_model->startWriteback(set_i, set_wb_blocks);
+						transit_sets ++;
+					}
+				} else {
 					/* Latency for invalidation */
-					//dram_delay += m_dram_bandwidth.getRoundedLatency(8 * 64 * set_wb_blocks);
 					cntlr_delay[vault_i] += m_dram_bandwidth.getRoundedLatency(8 * 64 * set_wb_blocks);
 					/*Overlapped by buss*/
-					//dram_delay += handleDramAccess(pkt_time, 8 * set_wb_blocks * 64, set_i, DramCntlrInterface::READ, perf); 
 					cntlr_delay[vault_i] += handleDramAccess(pkt_time, 8 * set_wb_blocks * 64, set_i, DramCntlrInterface::READ, perf); 
-					//dram_delay += dram_access_cost * set_wb_blocks;
-					m_set[set_i]->invalidateContent();
-					invalid_times ++;
-					invalid_blocks += set_wb_blocks;
-				} else if (migrated) {
-					//std::cout << "migrated!\n";
-					/* Latency for migration */
-					cntlr_delay[vault_i] += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::READ, perf); 
-					cntlr_delay[vault_i] += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::WRITE, perf); 
-					//dram_delay += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::READ, perf); 
-					//dram_delay += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::WRITE, perf); 
-					/*
-					dram_delay += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::TRANS, perf); 
-					dram_delay += handleDramAccess(pkt_time, set_valid_blocks * 64, set_i, DramCntlrInterface::TRANS, perf); 
-					*/
-					migrate_times ++;
-					migrate_blocks += set_valid_blocks;
 				}
-			
-
-				// [NEW_EXP]
-				/*
-				std::cout << "[REMAP_DEBUG] Amazing, we found an invalid row!\n"
-					      << "------wb_blocks: " << set_wb_blocks
-						  << "------valid blocks: " << set_valid_blocks
-						  << std::endl;
-						  */
-				
-				valid_blocks += set_valid_blocks;
-				writeback_blocks += set_wb_blocks;
+				set->invalidateContent();
+				/* the set is empty now, drop it from the bank index */
+				set->resident = false;
+				invalid_times ++;
+				invalid_blocks += set_wb_blocks;
 			}
+
+			valid_blocks += set_valid_blocks;
+			writeback_blocks += set_wb_blocks;
 		}
+		bank_sets.resize(n_kept);
 	}
 	// Paralellize the remapping operations
 	// find out a maximum delay in all controllers
@@ -762,12 +950,77 @@ StackDramCacheCntlrUnison::checkRemapping(SubsecondTime pkt_time, ShmemPerf *per
 	return dram_delay;
 }
 
+UInt32
+StackDramCacheCntlrUnison::movePages(UInt32 set_i)
+{
+	UInt32 remap_set_n = m_dram_perf_model->getRemapSet(set_i);
+	DramCacheSetUnison* src = m_set[set_i];
+	if (src == NULL || remap_set_n == set_i)
+		return 0;
+	DramCacheSetUnison* dst = getSet(remap_set_n);
+
+	/* through the replacement of the remapped set, as its own page misses */
+	UInt32 writeback_blocks = 0;
+	for (UInt32 way = 0; way < m_associativity; way++) {
+		if (!src->isValid(way))
+			continue;
+		UInt32 index = dst->getReplacementIndex();
+		if (dst->isValid(index)) {
+			UInt32 used = dst->getFootprint(index);
+			m_fht->update(dst->getTrigger(index), used);
+			m_fht->recordEviction(dst->getPredicted(index), used);
+		}
+		writeback_blocks += dst->invalidatePage(index);
+		dst->movePage(index, src, way);
+		moved_pages ++;
+	}
+	m_set_info->m_repl_policy->writebacks += writeback_blocks;
+
+	src->invalidateContent();
+	src->resident = false;
+	markResident(remap_set_n, dst);
+	return writeback_blocks;
+}
+
+void
+StackDramCacheCntlrUnison::markResident(UInt32 set_n, DramCacheSetUnison* set)
+{
+	if (set->resident)
+		return;
+	UInt32 vault_i = 0, bank_i = 0, row_i = 0;
+	m_dram_perf_model->splitSetNum(set_n, &vault_i, &bank_i, &row_i);
+	m_bank_sets[vault_i * m_dram_perf_model->n_banks + bank_i].push_back(set_n);
+	set->resident = true;
+}
+
+SubsecondTime
+StackDramCacheCntlrUnison::finishTransit(SubsecondTime pkt_time, UInt32 set_n, ShmemPerf *perf)
+{
+	SubsecondTime delay = SubsecondTime::Zero();
+	bool writeback = false;
+	UInt32 n_blocks = m_dram_perf_model->claimMigration(set_n, &writeback);
+	if (n_blocks == 0)
+		return delay;
+
+	/* the pages of a migrated row are in its remapped set already (movePages),
+	 * only the copy of the blocks the engine has not sent is left to time */
+	demand_transit_sets ++;
+	demand_transit_blocks += n_blocks;
+	delay += handleDramAccess(pkt_time, n_blocks * 64, set_n, DramCntlrInterface::READ, perf);
+	if (writeback) {
+		delay += m_dram_bandwidth.getRoundedLatency(8 * 64 * n_blocks);
+	} else {
+		UInt32 remap_set_n = m_dram_perf_model->getRemapSet(set_n);
+		delay += handleDramAccess(pkt_time + delay, n_blocks * 64, remap_set_n, DramCntlrInterface::WRITE, perf);
+	}
+	return delay;
+}
+
 SubsecondTime
 StackDramCacheCntlrUnison::handleDramAccess(SubsecondTime pkt_time, UInt32 pkt_size, UInt32 set_n, DramCntlrInterface::access_t access_type, ShmemPerf *perf) {
-	int bandwidth = 128;
-	bandwidth = Sim()->getCfg()->getInt("perf_model/stacked_dram/bandwidth");
-	int obus_delay = Sim()->getCfg()->getInt("perf_model/stacked_dram/obus_delay");
-	bool on_top = Sim()->getCfg()->getBoolDefault("perf_model/stacked_dram/on_top", true);
+	int bandwidth = m_config->bandwidth;
+	int obus_delay = m_config->obus_delay;
+	bool on_top = m_config->on_top;
 	int req_times = pkt_size / bandwidth;
 	if (req_times < 1) {
 		req_times = 1;
@@ -792,15 +1045,7 @@ StackDramCacheCntlrUnison::translateAddress(IntPtr address)
 {
 	IntPtr offset = address & ((1 << 12) - 1);
 	IntPtr v_tag = address >> 12;
-	IntPtr p_tag = v_tag;
-	
-	if (page_table.find(v_tag) != page_table.end()) {
-		p_tag = page_table[v_tag];
-	} else {
-		page_table[v_tag] = avail_phy_page_tag;
-		p_tag = avail_phy_page_tag;
-		avail_phy_page_tag ++;
-	}
+	IntPtr p_tag = page_table->translate(v_tag);
 	return ((p_tag << 12) | offset);
 }
 
@@ -826,18 +1071,16 @@ DramPerfModelNormal::DramPerfModelNormal(core_id_t core_id,
       UInt32 cache_block_size):
    DramPerfModel(core_id, cache_block_size),
    m_queue_model(NULL),
-   m_dram_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth")), // Convert bytes to bits
+   m_dram_bandwidth(8 * StackedDramConfig::getSingleton()->per_controller_bandwidth), // Convert bytes to bits
    m_total_queueing_delay(SubsecondTime::Zero()),
    m_total_access_latency(SubsecondTime::Zero())
 {
-   SubsecondTime dram_latency = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/latency"))); // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
-   SubsecondTime dram_latency_stddev = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/normal/standard_deviation")));
+   StackedDramConfig* config = StackedDramConfig::getSingleton();
+   m_dram_access_cost = new NormalTimeDistribution(config->dram_latency, config->dram_latency_stddev);
 
-   m_dram_access_cost = new NormalTimeDistribution(dram_latency, dram_latency_stddev);
-
-   if (Sim()->getCfg()->getBool("perf_model/dram/queue_model/enabled"))
+   if (config->queue_model)
    {
-      m_queue_model = QueueModel::create("dram-queue", core_id, Sim()->getCfg()->getString("perf_model/dram/queue_model/type"),
+      m_queue_model = QueueModel::create("dram-queue", core_id, config->queue_model_type,
                                          m_dram_bandwidth.getRoundedLatency(8 * cache_block_size)); // bytes to bits
    }
 
@@ -848,10 +1091,49 @@ DramPerfModelNormal::DramPerfModelNormal(core_id_t core_id,
    /*
 	  Initialize a dram cache controller
 	  */
-   UInt32 stacked_dram_size = Sim()->getCfg()->getInt("perf_model/dram_cache/cache_size");
+   UInt32 stacked_dram_size = StackedDramConfig::getSingleton()->cache_size;
    stacked_dram_size *= 1024;
    //m_dram_cache_cntlr = new StackDramCacheCntlrUnison(StackedDramSize/StackedSetSize, StackedAssoc, StackedBlockSize, StackedPageSize);
    m_dram_cache_cntlr = new StackDramCacheCntlrUnison(stacked_dram_size/StackedSetSize, StackedAssoc, StackedBlockSize, StackedPageSize);
+
+   FootprintHistoryTable* fht = m_dram_cache_cntlr->m_fht;
+   registerStatsMetric("dram-cache", core_id, "fht-lookups", &fht->lookups);
+   registerStatsMetric("dram-cache", core_id, "fht-hits", &fht->hits);
+   registerStatsMetric("dram-cache", core_id, "fht-fetched-blocks", &fht->fetched_blocks);
+   registerStatsMetric("dram-cache", core_id, "fht-used-blocks", &fht->used_blocks);
+   registerStatsMetric("dram-cache", core_id, "fht-over-fetched-blocks", &fht->over_fetched_blocks);
+   registerStatsMetric("dram-cache", core_id, "fht-under-fetched-blocks", &fht->under_fetched_blocks);
+
+   DramCacheReplPolicy* repl = m_dram_cache_cntlr->m_set_info->m_repl_policy;
+   String repl_name = DramCacheReplPolicy::getName(repl->getPolicy());
+   registerStatsMetric("dram-cache", core_id, repl_name + "-hits", &repl->hits);
+   registerStatsMetric("dram-cache", core_id, repl_name + "-misses", &repl->misses);
+   registerStatsMetric("dram-cache", core_id, repl_name + "-writebacks", &repl->writebacks);
+
+   DramCacheTagCache* tag_cache = m_dram_cache_cntlr->m_tag_cache;
+   if (tag_cache) {
+      registerStatsMetric("dram-cache", core_id, "tag-cache-lookups", &tag_cache->lookups);
+      registerStatsMetric("dram-cache", core_id, "tag-cache-predictions", &tag_cache->predictions);
+      registerStatsMetric("dram-cache", core_id, "tag-cache-correct", &tag_cache->correct);
+      registerStatsMetric("dram-cache", core_id, "tag-cache-mispredictions", &tag_cache->mispredictions);
+      registerStatsMetric("dram-cache", core_id, "tag-cache-saved-requests", &tag_cache->saved_requests);
+   }
+
+   DramCacheBandwidthBalancer* batman = m_dram_cache_cntlr->m_batman;
+   if (batman) {
+      registerStatsMetric("dram-cache", core_id, "batman-bypassed-hits", &batman->bypassed_hits);
+      registerStatsMetric("dram-cache", core_id, "batman-stacked-bytes", &batman->stacked_bytes);
+      registerStatsMetric("dram-cache", core_id, "batman-offchip-bytes", &batman->offchip_bytes);
+      registerStatsMetric("dram-cache", core_id, "batman-epochs", &batman->epochs);
+      registerStatsMetric("dram-cache", core_id, "batman-saturated-epochs", &batman->saturated_epochs);
+   }
+
+   MigrationEngine* migration = m_dram_cache_cntlr->m_dram_perf_model->m_migration;
+   registerStatsMetric("dram-cache", core_id, "migration-copied-blocks", &migration->copied_blocks);
+   registerStatsMetric("dram-cache", core_id, "migration-written-back-blocks", &migration->written_back_blocks);
+   registerStatsMetric("dram-cache", core_id, "migration-claimed-blocks", &migration->claimed_blocks);
+   registerStatsMetric("dram-cache", core_id, "migration-delayed-demands", &migration->delayed_demands);
+   registerStatsMetric("dram-cache", core_id, "migration-exposed-cycles", &migration->exposed_cycles);
 }
 
 DramPerfModelNormal::~DramPerfModelNormal()
@@ -875,7 +1157,9 @@ DramPerfModelNormal::getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, c
 	//}
 	//std::cout << "[DRAM_PERF_MODEL] before process a request\n";
 	SubsecondTime model_delay = SubsecondTime::Zero();
-	model_delay += m_dram_cache_cntlr->ProcessRequest(pkt_time, pkt_size, access_type, address, perf);
+	/* The DRAM controller interface does not carry the instruction pointer,
+	 * the requesting core is the finest program context available here */
+	model_delay += m_dram_cache_cntlr->ProcessRequest(pkt_time, pkt_size, access_type, address, (IntPtr)requester, perf);
 	//std::cout << "[DRAM_PERF_MODEL] after process a request\n";
 
 	//printf("Normal Model# pkt_time: %ld, address: %ld\n", pkt_time.getMS(), address);
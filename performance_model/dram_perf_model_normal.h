@@ -2,6 +2,11 @@
 #define __DRAM_PERF_MODEL_NORMAL_H__
 
 #include "stacked_dram_cntlr.h"
+#include "footprint_history_table.h"
+#include "dram_cache_page_table.h"
+#include "dram_cache_tag_cache.h"
+#include "dram_cache_replacement.h"
+#include "dram_cache_batman.h"
 
 #include "utils.h"
 
@@ -22,105 +27,117 @@
 #include <iostream>
 #include <fstream>
 #include <map>
-
-class DramCachePageInfo
+#include <vector>
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+   Page metadata of SetsPerChunk consecutive sets
+   Stored as parallel arrays (structure of arrays) indexed by
+   set_in_chunk * associativity + way, so a lookup touches contiguous memory
+   instead of chasing one heap object per way
+   */
+class DramCachePageChunk
 {
 	public:
-		//page size = 1984B, Block size = 64B
-		// 1 page has 31 blocks
-		static const UInt32 BitsOfBlock = 5;
+		DramCachePageChunk(UInt32 associativity);
+		~DramCachePageChunk();
+
+		IntPtr* m_tags;
+		UInt32* m_vbits;
+		UInt32* m_dbits;
+		UInt32* m_footprint;
+		UInt8* m_used;	// replacement state (age or RRPV)
+		UInt32* m_predicted;	// footprint fetched on the page miss
+		UInt64* m_trigger;	// FHT key of the access which missed
+
+		/* Returns the way holding 'tag' in the set starting at 'base', associativity if none */
+		UInt32 findTag(UInt32 base, IntPtr tag) const;
+		/* Returns the number of dirty blocks written back */
+		UInt32 invalidatePage(UInt32 page);
+		bool accessBlock(UInt32 page, Core::mem_op_t type, UInt32 block_num);
 
 	private:
-		IntPtr m_tag;
-
-		UInt32 vbits_0;
-		UInt32 vbits_1;
-		UInt32 dbits_0;
-		UInt32 dbits_1;
-
-		UInt32 m_footprint;
-
-		CacheState::cstate_t m_cstate;
-
-		UInt8 m_used;
-		UInt8 pc;
-		UInt8 offset;
+		const UInt32 m_associativity;
+};
 
+/*
+   Shared by all sets: a sparse directory of page chunks,
+   a chunk is allocated when one of its sets is first touched
+   */
+class DramCacheSetInfoUnison
+{
 	public:
-		DramCachePageInfo();
-		DramCachePageInfo(IntPtr tag, CacheState::cstate_t cstate);
-
-		~DramCachePageInfo();
-
-		static DramCachePageInfo* create();
-
-		UInt32 invalidate(void);
-		void clone(DramCachePageInfo* cache_page_info);
-
-		bool isValid() const { return (m_tag != ((IntPtr) ~0)); }
-
-		IntPtr getTag() const { return m_tag; }
-		CacheState::cstate_t getCState() const { return m_cstate; }
-		UInt32 getValidBits() const { return vbits_0; }
-		UInt32 getDirtyBits() const { return dbits_0; }
-		UInt32 getFootprint() const { return m_footprint; }
+		//page size = 1984B, Block size = 64B
+		// 1 page has 31 blocks
+		static const UInt32 BitsOfBlock = 5;
+		static const UInt32 SetsPerChunk = 1024;
 
-		void setTag(IntPtr tag) { m_tag = tag; }
-		void setCState(CacheState::cstate_t cstate) { m_cstate = cstate; }
-		void setValidBits(UInt32 v) { vbits_0 = v; }
-		void setDirtyBits(UInt32 d) { dbits_0 = d; }
-		void setFootprint(UInt32 f) { m_footprint = f; }
+		DramCacheSetInfoUnison(UInt32 associativity, UInt32 set_num, DramCacheReplPolicy* repl_policy);
+		~DramCacheSetInfoUnison();
 
-		UInt8 getUsage() const { return m_used; }
-		bool updateUsage(UInt32 offset, UInt32 size);
-		bool updateUsage(UInt32 used);
+		DramCachePageChunk* getChunk(UInt32 set_index);
 
-		bool accessBlock(Core::mem_op_t, UInt32);
+		/* shared by all sets, state is m_used of each page */
+		DramCacheReplPolicy* m_repl_policy;
 
-		void loadBlocks(UInt32 footprint);
-};
+		UInt32 allocated_chunks;
 
-class DramCacheSetInfoUnison
-{
-	public:
-		DramCacheSetInfoUnison(UInt32 associativity);
-		~DramCacheSetInfoUnison();
 	private:
 		const UInt32 m_associativity;
+		const UInt32 m_set_num;
+		UInt32 m_chunk_num;
+		DramCachePageChunk** m_chunks;
 };
 
 class DramCacheSetUnison
 {
 	public:
 		DramCacheSetUnison(UInt32 associativity, UInt32 blocksize, 
-				DramCacheSetInfoUnison* set_info);
+				DramCacheSetInfoUnison* set_info, UInt32 set_index);
 		~DramCacheSetUnison();
 
 		UInt32 getReplacementIndex();
 		UInt32 invalidateContent();
+		UInt32 invalidatePage(UInt32 index);
+		/* Returns the way holding 'tag', associativity if none */
+		UInt32 findWay(IntPtr tag);
+		UInt32 getFootprint(UInt32 index);
+		UInt32 getPredicted(UInt32 index);
+		UInt64 getTrigger(UInt32 index);
+		bool isValid(UInt32 index);
+		bool isDirty(UInt32 index, UInt32 block_num);
 		UInt32 getDirtyBlocks();
 		UInt32 getValidBlocks();
+		/* Invalidate the clean blocks, returns the number of dirty blocks kept */
+		UInt32 dropCleanBlocks();
 		void updateReplacementIndex(UInt32);
 		void updateReplacementIndexTag(UInt32 index, IntPtr tag, IntPtr pc, IntPtr offset, UInt32 footprint);
 
 		void updateUsedInfo(IntPtr tag);
+		/* Install the page 'src_index' of another set in way 'index' with its
+		 * valid, dirty and footprint bits, as a fill of this set */
+		void movePage(UInt32 index, DramCacheSetUnison* src, UInt32 src_index);
 
 		UInt8 accessAttempt(Core::mem_op_t type, IntPtr tag, IntPtr offset);
 
 		int reads;
 		int writes;
+		/* indexed in StackDramCacheCntlrUnison::m_bank_sets */
+		bool resident;
 
 		UInt32 n_vault;
 		UInt32 n_bank;
 		UInt32 n_level;
 
-		DramCachePageInfo** m_cache_page_info_array;
-
 	protected:
-		UInt8* m_lru_bits;
 		DramCacheSetInfoUnison* m_set_info;
+		DramCachePageChunk* m_pages;
 		const UInt32 m_associativity;
-		void moveToMRU(UInt32 accessed_index);
+		const UInt32 m_set_index;
+		const UInt32 m_base;
 };
 
 class StackDramCacheCntlrUnison
@@ -138,9 +155,13 @@ class StackDramCacheCntlrUnison
 
 		DramCacheSetInfoUnison* m_set_info;
 		DramCacheSetUnison** m_set;
-		bool* m_set_thermal_valid;
+		std::vector<UInt32> m_touched_sets;
+		/* Resident (filled) sets of each bank, vault * n_banks + bank */
+		std::vector<std::vector<UInt32> > m_bank_sets;
 
-		UInt32 FHT[31];	// footprint history table
+		FootprintHistoryTable* m_fht;
+		DramCacheTagCache* m_tag_cache;	// NULL if disabled
+		DramCacheBandwidthBalancer* m_batman;	// NULL if disabled
 
 		UInt32 m_set_num;
 		UInt32 m_associativity;
@@ -160,10 +181,16 @@ class StackDramCacheCntlrUnison
 		UInt32 cache_access_no_roi, page_misses_no_roi, block_misses_no_roi;
 		UInt32 wb_blocks, ld_blocks;
 		UInt32 invalid_times, invalid_blocks, migrate_times, migrate_blocks;
+		UInt32 swap_sets, swap_blocks;
+		UInt32 transit_sets, demand_transit_sets, demand_transit_blocks;
+		UInt32 moved_pages;
 
 		//log file
 		std::ofstream log_file;
 
+		//Configuration snapshot
+		StackedDramConfig* m_config;
+
 		//Performance model
 		StackedDramPerfUnison* m_dram_perf_model;
 		bool remap_invalid;
@@ -172,19 +199,27 @@ class StackDramCacheCntlrUnison
 		StackDramCacheCntlrUnison(UInt32 set_num, UInt32 associativity, UInt32 blocksize, UInt32 pagesize);
 		~StackDramCacheCntlrUnison();
 
-		SubsecondTime ProcessRequest(SubsecondTime pkt_time, UInt64 pkt_size, DramCntlrInterface::access_t access_type, IntPtr address, ShmemPerf *perf);
+		SubsecondTime ProcessRequest(SubsecondTime pkt_time, UInt64 pkt_size, DramCntlrInterface::access_t access_type, IntPtr address, IntPtr pc, ShmemPerf *perf);
 		/* Functions to handle remapping */
 		SubsecondTime checkRemapping(SubsecondTime pkt_time, ShmemPerf *perf);
+		/* Lazy migration: copy or write back the blocks of a set in transit not drained yet */
+		SubsecondTime finishTransit(SubsecondTime pkt_time, UInt32 set_n, ShmemPerf *perf);
 		void invalidateBank();
+		/* Move the pages of a migrated row to the set serving it now, returns the
+		 * dirty blocks of the pages they evict there */
+		UInt32 movePages(UInt32 set_i);
+		/* Index a set which got its first page in m_bank_sets */
+		void markResident(UInt32 set_n, DramCacheSetUnison* set);
 
 		SubsecondTime handleDramAccess(SubsecondTime pkt_time, UInt32 pkt_size, UInt32 set_n, DramCntlrInterface::access_t access_type, ShmemPerf *perf);
 
 		/* Virtual-Physical Page Table*/
-		UInt32 avail_phy_page_tag;
-		std::map<IntPtr, IntPtr> page_table;
+		DramCachePageTable* page_table;
 		IntPtr translateAddress(IntPtr address);
 
 		bool SplitAddress(IntPtr address, UInt32 *set_n, IntPtr *page_tag, IntPtr *page_offset);
+		/* Returns the set, creating it on first touch */
+		DramCacheSetUnison* getSet(UInt32 set_n);
 
 		friend class DramPerfModelNormal;
 
@@ -0,0 +1,36 @@
+#include "footprint_history_table.h"
+
+FootprintHistoryTable::FootprintHistoryTable(UInt32 n_entries, UInt32 associativity)
+	: lookups(0), hits(0),
+	  fetched_blocks(0), used_blocks(0),
+	  over_fetched_blocks(0), under_fetched_blocks(0),
+	  m_table(n_entries, associativity)
+{
+}
+
+bool
+FootprintHistoryTable::lookup(UInt64 key, UInt32* footprint)
+{
+	lookups++;
+	UInt32* entry = m_table.lookup(key, key);
+	if (entry == NULL)
+		return false;
+	*footprint = *entry;
+	hits++;
+	return true;
+}
+
+void
+FootprintHistoryTable::update(UInt64 key, UInt32 footprint)
+{
+	m_table.insert(key, key, footprint);
+}
+
+void
+FootprintHistoryTable::recordEviction(UInt32 predicted, UInt32 used)
+{
+	fetched_blocks += __builtin_popcount(predicted);
+	used_blocks += __builtin_popcount(used);
+	over_fetched_blocks += __builtin_popcount(predicted & ~used);
+	under_fetched_blocks += __builtin_popcount(used & ~predicted);
+}
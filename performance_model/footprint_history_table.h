@@ -0,0 +1,38 @@
+#ifndef __FOOTPRINT_HISTORY_TABLE_H__
+#define __FOOTPRINT_HISTORY_TABLE_H__
+
+#include "fixed_types.h"
+#include "assoc_lru_table.h"
+
+/*
+ * Footprint History Table (Unison cache)
+ *   Predicts which blocks of a page will be used, indexed by the
+ *   (PC, offset) pair of the access that triggered the page miss.
+ *   Set-associative, LRU replacement.
+ */
+class FootprintHistoryTable {
+	public:
+		FootprintHistoryTable(UInt32 n_entries, UInt32 associativity);
+
+		/* Key stored with a page, used to train the table when it is evicted */
+		static UInt64 getKey(IntPtr pc, UInt32 block_num) { return ((UInt64)pc << 5) | (block_num & 31); }
+
+		/* Returns true and the predicted footprint if the key is in the table */
+		bool lookup(UInt64 key, UInt32* footprint);
+		/* Train with the footprint observed when a page is evicted */
+		void update(UInt64 key, UInt32 footprint);
+
+		/* Compare the footprint fetched for a page with the one really used */
+		void recordEviction(UInt32 predicted, UInt32 used);
+
+		/* Statistics */
+		UInt64 lookups, hits;
+		UInt64 fetched_blocks, used_blocks;
+		UInt64 over_fetched_blocks, under_fetched_blocks;
+
+	private:
+		/* (PC, offset) key -> footprint */
+		AssocLruTable<UInt64, UInt32> m_table;
+};
+
+#endif /* __FOOTPRINT_HISTORY_TABLE_H__ */
@@ -0,0 +1,239 @@
+#include "hot_row_tracker.h"
+
+HotRowTracker::HotRowTracker(UInt32 capacity)
+	: m_capacity(0), m_used(0),
+	  m_rows(NULL), m_errors(NULL), m_bucket(NULL), m_prev(NULL), m_next(NULL),
+	  m_bcount(NULL), m_bhead(NULL), m_bprev(NULL), m_bnext(NULL),
+	  m_index(NULL), m_index_mask(0)
+{
+	resize(capacity);
+}
+
+HotRowTracker::~HotRowTracker()
+{
+	release();
+}
+
+void
+HotRowTracker::release()
+{
+	delete [] m_rows;
+	delete [] m_errors;
+	delete [] m_bucket;
+	delete [] m_prev;
+	delete [] m_next;
+	delete [] m_bcount;
+	delete [] m_bhead;
+	delete [] m_bprev;
+	delete [] m_bnext;
+	delete [] m_index;
+}
+
+void
+HotRowTracker::resize(UInt32 capacity)
+{
+	release();
+	m_capacity = capacity;
+
+	/* there are never more distinct counts than counters */
+	UInt32 n = m_capacity > 0 ? m_capacity : 1;
+	m_rows = new UInt32[n];
+	m_errors = new UInt32[n];
+	m_bucket = new UInt32[n];
+	m_prev = new UInt32[n];
+	m_next = new UInt32[n];
+	m_bcount = new UInt32[n];
+	m_bhead = new UInt32[n];
+	m_bprev = new UInt32[n];
+	m_bnext = new UInt32[n];
+
+	/* keep the index at most half full */
+	UInt32 index_size = 2;
+	while (index_size < 2 * n)
+		index_size <<= 1;
+	m_index = new UInt32[index_size];
+	m_index_mask = index_size - 1;
+
+	reset();
+}
+
+void
+HotRowTracker::reset()
+{
+	m_used = 0;
+	m_bmin = m_bmax = NIL;
+	m_bfree = NIL;
+	for (UInt32 i = m_capacity; i > 0; i--) {
+		m_bnext[i - 1] = m_bfree;
+		m_bfree = i - 1;
+	}
+	for (UInt32 i = 0; i <= m_index_mask; i++)
+		m_index[i] = NIL;
+}
+
+void
+HotRowTracker::access(UInt32 row)
+{
+	if (m_capacity == 0)
+		return;
+
+	UInt32 slot = find(row);
+	if (slot != NIL) {
+		increment(slot);
+	} else if (m_used < m_capacity) {
+		slot = m_used++;
+		m_rows[slot] = row;
+		m_errors[slot] = 0;
+		indexInsert(slot);
+		if (m_bmin == NIL || m_bcount[m_bmin] != 1)
+			attach(slot, newBucket(1, NIL));
+		else
+			attach(slot, m_bmin);
+	} else {
+		/* take over a counter of the lowest count */
+		slot = m_bhead[m_bmin];
+		indexErase(m_rows[slot]);
+		m_rows[slot] = row;
+		m_errors[slot] = m_bcount[m_bmin];
+		indexInsert(slot);
+		increment(slot);
+	}
+}
+
+UInt32
+HotRowTracker::count(UInt32 row) const
+{
+	if (m_capacity == 0)
+		return 0;
+	UInt32 slot = find(row);
+	return slot == NIL ? 0 : m_bcount[m_bucket[slot]];
+}
+
+void
+HotRowTracker::getHotRows(std::vector<UInt32>* rows, UInt32 min_count) const
+{
+	rows->clear();
+	for (UInt32 b = m_bmax; b != NIL && m_bcount[b] >= min_count; b = m_bprev[b]) {
+		for (UInt32 s = m_bhead[b]; s != NIL; s = m_next[s])
+			rows->push_back(m_rows[s]);
+	}
+}
+
+UInt32
+HotRowTracker::find(UInt32 row) const
+{
+	for (UInt32 i = hash(row); m_index[i] != NIL; i = (i + 1) & m_index_mask) {
+		if (m_rows[m_index[i]] == row)
+			return m_index[i];
+	}
+	return NIL;
+}
+
+void
+HotRowTracker::indexInsert(UInt32 slot)
+{
+	UInt32 i = hash(m_rows[slot]);
+	while (m_index[i] != NIL)
+		i = (i + 1) & m_index_mask;
+	m_index[i] = slot;
+}
+
+void
+HotRowTracker::indexErase(UInt32 row)
+{
+	UInt32 i = hash(row);
+	while (m_rows[m_index[i]] != row)
+		i = (i + 1) & m_index_mask;
+
+	/* shift the following entries back instead of leaving a tombstone */
+	UInt32 j = i;
+	while (true) {
+		j = (j + 1) & m_index_mask;
+		if (m_index[j] == NIL)
+			break;
+		UInt32 h = hash(m_rows[m_index[j]]);
+		/* the entry at j may move to i if its home is not in (i, j] */
+		if (((j - h) & m_index_mask) >= ((j - i) & m_index_mask)) {
+			m_index[i] = m_index[j];
+			i = j;
+		}
+	}
+	m_index[i] = NIL;
+}
+
+UInt32
+HotRowTracker::newBucket(UInt32 count, UInt32 prev)
+{
+	UInt32 b = m_bfree;
+	m_bfree = m_bnext[b];
+
+	m_bcount[b] = count;
+	m_bhead[b] = NIL;
+	m_bprev[b] = prev;
+	m_bnext[b] = prev == NIL ? m_bmin : m_bnext[prev];
+	if (m_bprev[b] == NIL)
+		m_bmin = b;
+	else
+		m_bnext[m_bprev[b]] = b;
+	if (m_bnext[b] == NIL)
+		m_bmax = b;
+	else
+		m_bprev[m_bnext[b]] = b;
+	return b;
+}
+
+void
+HotRowTracker::attach(UInt32 slot, UInt32 bucket)
+{
+	m_bucket[slot] = bucket;
+	m_prev[slot] = NIL;
+	m_next[slot] = m_bhead[bucket];
+	if (m_next[slot] != NIL)
+		m_prev[m_next[slot]] = slot;
+	m_bhead[bucket] = slot;
+}
+
+void
+HotRowTracker::detach(UInt32 slot)
+{
+	UInt32 b = m_bucket[slot];
+	if (m_prev[slot] == NIL)
+		m_bhead[b] = m_next[slot];
+	else
+		m_next[m_prev[slot]] = m_next[slot];
+	if (m_next[slot] != NIL)
+		m_prev[m_next[slot]] = m_prev[slot];
+
+	if (m_bhead[b] != NIL)
+		return;
+	/* the bucket is empty, unlink and free it */
+	if (m_bprev[b] == NIL)
+		m_bmin = m_bnext[b];
+	else
+		m_bnext[m_bprev[b]] = m_bnext[b];
+	if (m_bnext[b] == NIL)
+		m_bmax = m_bprev[b];
+	else
+		m_bprev[m_bnext[b]] = m_bprev[b];
+	m_bnext[b] = m_bfree;
+	m_bfree = b;
+}
+
+void
+HotRowTracker::increment(UInt32 slot)
+{
+	UInt32 b = m_bucket[slot];
+	UInt32 count = m_bcount[b] + 1;
+	UInt32 nb = m_bnext[b];
+
+	if (nb != NIL && m_bcount[nb] == count) {
+		detach(slot);
+		attach(slot, nb);
+	} else if (m_bhead[b] == slot && m_next[slot] == NIL) {
+		/* alone in its bucket, which stays in order */
+		m_bcount[b] = count;
+	} else {
+		detach(slot);
+		attach(slot, newBucket(count, b));
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef __HOT_ROW_TRACKER_H__
+#define __HOT_ROW_TRACKER_H__
+
+#include "fixed_types.h"
+
+#include <vector>
+
+/*
+ * Hot row tracker of a bank (Space-Saving, stream-summary)
+ *   Keeps at most 'capacity' rows with their access counts. A row which is
+ *   not tracked replaces a row of the lowest count and inherits that count
+ *   (+1), so a row accessed more than N/capacity times out of N is never lost.
+ *   The counters are grouped in buckets of equal count, linked in ascending
+ *   order, and a row is found with an open addressing index: an access and
+ *   an eviction are O(1), and nothing is allocated after resize().
+ */
+class HotRowTracker {
+	public:
+		HotRowTracker(UInt32 capacity = 0);
+		~HotRowTracker();
+
+		/* Reallocate for 'capacity' rows and forget all of them */
+		void resize(UInt32 capacity);
+		void reset();
+
+		void access(UInt32 row);
+
+		UInt32 capacity() const { return m_capacity; }
+		UInt32 size() const { return m_used; }
+		/* Estimated count of a row, 0 if it is not tracked */
+		UInt32 count(UInt32 row) const;
+		/* Rows counted at least 'min_count' times, hottest first */
+		void getHotRows(std::vector<UInt32>* rows, UInt32 min_count = 1) const;
+
+	private:
+		static const UInt32 NIL = 0xFFFFFFFF;
+
+		UInt32 m_capacity;
+		UInt32 m_used;
+
+		/* counters: row, count over-estimation, bucket and neighbours in it */
+		UInt32* m_rows;
+		UInt32* m_errors;
+		UInt32* m_bucket;
+		UInt32* m_prev;
+		UInt32* m_next;
+
+		/* buckets: count, first counter, neighbours in ascending count order */
+		UInt32* m_bcount;
+		UInt32* m_bhead;
+		UInt32* m_bprev;
+		UInt32* m_bnext;
+		UInt32 m_bmin, m_bmax;
+		UInt32 m_bfree;	// free buckets, linked with m_bnext
+
+		/* row -> counter, linear probing, NIL is an empty entry */
+		UInt32* m_index;
+		UInt32 m_index_mask;
+
+		void release();
+
+		UInt32 hash(UInt32 row) const { return (row * 0x9E3779B1U) & m_index_mask; }
+		UInt32 find(UInt32 row) const;
+		void indexInsert(UInt32 slot);
+		void indexErase(UInt32 row);
+
+		UInt32 newBucket(UInt32 count, UInt32 prev);
+		void attach(UInt32 slot, UInt32 bucket);
+		void detach(UInt32 slot);
+		void increment(UInt32 slot);
+};
+
+#endif /* __HOT_ROW_TRACKER_H__ */
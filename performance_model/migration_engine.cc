@@ -0,0 +1,168 @@
+#include "migration_engine.h"
+
+MigrationEngine::MigrationEngine(DramModel* dram_model, UInt32 n_vaults, UInt32 block_size, UInt32 window)
+	: copied_blocks(0), copy_bytes(0),
+	  written_back_blocks(0), claimed_blocks(0),
+	  delayed_demands(0), exposed_cycles(0),
+	  m_dram_model(dram_model),
+	  m_block_size(block_size),
+	  m_window(window > 0 ? window : 1),
+	  m_jobs(n_vaults),
+	  m_writes(n_vaults),
+	  m_queued(0),
+	  m_in_flight(n_vaults, 0),
+	  m_last_done(n_vaults, -1),
+	  m_in_flight_tot(0),
+	  m_demand_clk(0),
+	  m_demand_overlap(false)
+{
+}
+
+MigrationEngine::~MigrationEngine()
+{
+	/* nothing to report unless a swap or a lazy migration used the engine */
+	if (copied_blocks + written_back_blocks + claimed_blocks == 0)
+		return;
+	std::cout << "[MIGRATION OUTPUT]" << std::endl;
+	std::cout << "Copied blocks: " << copied_blocks << ", copy bytes: " << copy_bytes << std::endl;
+	std::cout << "Written back blocks: " << written_back_blocks
+			  << ", blocks claimed by demand accesses: " << claimed_blocks << std::endl;
+	std::cout << "Demand accesses delayed by copies: " << delayed_demands
+			  << ", exposed DRAM cycles: " << exposed_cycles << std::endl;
+	std::cout << "[MIGRATION OUTPUT]" << std::endl;
+}
+
+void
+MigrationEngine::enqueue(UInt32 src_vault, UInt32 src_bank, UInt32 src_row,
+		UInt32 dst_vault, UInt32 dst_bank, UInt32 dst_row, UInt32 n_blocks)
+{
+	if (n_blocks == 0)
+		return;
+	Job job = {src_vault, src_bank, src_row, dst_vault, dst_bank, dst_row, 0, n_blocks, false};
+	m_jobs[src_vault].push_back(job);
+	m_queued++;
+}
+
+void
+MigrationEngine::enqueueWriteback(UInt32 vault, UInt32 bank, UInt32 row, UInt32 n_blocks)
+{
+	if (n_blocks == 0)
+		return;
+	Job job = {vault, bank, row, vault, bank, row, 0, n_blocks, true};
+	m_jobs[vault].push_back(job);
+	m_queued++;
+}
+
+UInt32
+MigrationEngine::claim(UInt32 src_vault, UInt32 src_bank, UInt32 row, bool* writeback)
+{
+	std::deque<Job>& jobs = m_jobs[src_vault];
+	for (std::deque<Job>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+		if (it->src_bank != src_bank || it->src_row != row)
+			continue;
+		UInt32 n_blocks = it->n_blocks - it->next_block;
+		*writeback = it->writeback;
+		claimed_blocks += n_blocks;
+		jobs.erase(it);
+		m_queued--;
+		return n_blocks;
+	}
+	return 0;
+}
+
+void
+MigrationEngine::runUntil(UInt64 time_ns)
+{
+	/* the DRAM would idle until the demand access: copy meanwhile */
+	while (busy()) {
+		issue();
+		if (!m_dram_model->stepTowards(time_ns))
+			break;
+	}
+}
+
+void
+MigrationEngine::issue()
+{
+	if (m_queued == 0)
+		return;
+	for (UInt32 v = 0; v < m_jobs.size(); v++)
+		issueVault(v);
+}
+
+void
+MigrationEngine::issueVault(UInt32 vault)
+{
+	/* finish the blocks already read first */
+	std::deque<Write>& writes = m_writes[vault];
+	while (!writes.empty() && m_in_flight[vault] < m_window) {
+		Write w = writes.front();
+		if (!m_dram_model->post(RamRequest::Type::WRITE, w.vault, w.bank, w.row, w.col,
+					[this, w](RamRequest& r) {
+						copied_blocks++;
+						copy_bytes += m_block_size;
+						complete(w.vault, r.depart);
+					}))
+			return;
+		m_in_flight[vault]++;
+		m_in_flight_tot++;
+		writes.pop_front();
+		m_queued--;
+	}
+
+	std::deque<Job>& jobs = m_jobs[vault];
+	while (!jobs.empty() && m_in_flight[vault] < m_window) {
+		Job& job = jobs.front();
+		bool writeback = job.writeback;
+		Write w = {job.dst_vault, job.dst_bank, job.dst_row, job.next_block};
+		if (!m_dram_model->post(RamRequest::Type::READ, vault, job.src_bank, job.src_row, job.next_block,
+					[this, vault, writeback, w](RamRequest& r) {
+						/* a written back block leaves the stack */
+						if (writeback) {
+							written_back_blocks++;
+						} else {
+							m_writes[w.vault].push_back(w);
+							m_queued++;
+						}
+						complete(vault, r.depart);
+					}))
+			return;
+		m_in_flight[vault]++;
+		m_in_flight_tot++;
+		if (++job.next_block == job.n_blocks) {
+			jobs.pop_front();
+			m_queued--;
+		}
+	}
+}
+
+void
+MigrationEngine::complete(UInt32 vault, long depart)
+{
+	m_in_flight[vault]--;
+	m_in_flight_tot--;
+	if (depart > m_last_done[vault])
+		m_last_done[vault] = depart;
+}
+
+void
+MigrationEngine::beginDemand(UInt32 vault)
+{
+	m_demand_clk = m_dram_model->memory->ctrls[vault]->clk;
+	m_demand_overlap = m_in_flight[vault] > 0;
+}
+
+void
+MigrationEngine::endDemand(UInt32 vault, UInt32 latency)
+{
+	if (!m_demand_overlap)
+		return;
+	/* the demand waited at most until the last copy ahead of it completed */
+	long overlap = latency;
+	if (m_in_flight[vault] == 0 && m_last_done[vault] - m_demand_clk < overlap)
+		overlap = m_last_done[vault] - m_demand_clk;
+	if (overlap > 0) {
+		delayed_demands++;
+		exposed_cycles += overlap;
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef __MIGRATION_ENGINE_H__
+#define __MIGRATION_ENGINE_H__
+
+#include "fixed_types.h"
+#include "ramulator/dram_sim.h"
+
+#include <deque>
+#include <vector>
+
+/*
+ * Background copy engine of the stacked DRAM (swap remapping)
+ *   When two banks swap their physical location, the dirty blocks of their
+ *   resident sets are queued here. Each block is read from the old physical
+ *   bank and written to the new one by requests sent to ramulator in the
+ *   idle DRAM cycles before the next demand access, so no core waits for a
+ *   copy. Every vault has its own queues and at most 'window' copy requests
+ *   in flight, so a busy vault does not hold back the copies of the others.
+ *   The demand accesses which meet some of them in their vault are accounted
+ *   as exposed.
+ * Lazy migration also queues here the hot rows of a combined bank and the
+ *   dirty blocks of an invalidated one (read only, written back off-chip).
+ *   Such a row stays in transit until it is drained, or until a demand
+ *   access claims the blocks not sent yet and copies them itself.
+ */
+class MigrationEngine {
+	public:
+		MigrationEngine(DramModel* dram_model, UInt32 n_vaults, UInt32 block_size, UInt32 window);
+		~MigrationEngine();
+
+		/* Copy 'n_blocks' blocks of a row from one physical bank to another */
+		void enqueue(UInt32 src_vault, UInt32 src_bank, UInt32 src_row,
+				UInt32 dst_vault, UInt32 dst_bank, UInt32 dst_row, UInt32 n_blocks);
+		/* Read 'n_blocks' dirty blocks of a row for the write back to the main memory */
+		void enqueueWriteback(UInt32 vault, UInt32 bank, UInt32 row, UInt32 n_blocks);
+		/* Remove the queued copy of a row, the blocks not sent yet are returned to the caller */
+		UInt32 claim(UInt32 src_vault, UInt32 src_bank, UInt32 row, bool* writeback);
+		/* Fill the DRAM cycles up to 'time_ns' with copy traffic */
+		void runUntil(UInt64 time_ns);
+		bool busy() const { return m_queued > 0 || m_in_flight_tot > 0; }
+
+		/* Around the demand access of a vault, 'latency' in DRAM cycles */
+		void beginDemand(UInt32 vault);
+		void endDemand(UInt32 vault, UInt32 latency);
+
+		/* Statistics */
+		UInt64 copied_blocks, copy_bytes;
+		UInt64 written_back_blocks, claimed_blocks;
+		UInt64 delayed_demands, exposed_cycles;
+
+	private:
+		struct Job {
+			UInt32 src_vault, src_bank, src_row, dst_vault, dst_bank, dst_row;
+			UInt32 next_block, n_blocks;
+			bool writeback;
+		};
+		struct Write {
+			UInt32 vault, bank, row, col;
+		};
+
+		DramModel* m_dram_model;
+		UInt32 m_block_size;
+		UInt32 m_window;
+
+		/* rows to copy, by source vault */
+		std::vector<std::deque<Job> > m_jobs;
+		/* blocks read from their source, not yet sent to their destination, by destination vault */
+		std::vector<std::deque<Write> > m_writes;
+		/* entries of all the queues above */
+		UInt32 m_queued;
+		/* copy requests in each vault and the DRAM cycle the last one completed */
+		std::vector<UInt32> m_in_flight;
+		std::vector<long> m_last_done;
+		UInt32 m_in_flight_tot;
+
+		long m_demand_clk;
+		bool m_demand_overlap;
+
+		/* Send as many copy requests as the windows and the queues take */
+		void issue();
+		void issueVault(UInt32 vault);
+		void complete(UInt32 vault, long depart);
+};
+
+#endif /* __MIGRATION_ENGINE_H__ */
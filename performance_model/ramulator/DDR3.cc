@@ -0,0 +1,217 @@
+#include "DDR3.h"
+#include "RamDRAM.h"
+
+#include <vector>
+#include <functional>
+#include <cassert>
+
+using namespace std;
+using namespace ramulator;
+
+map<string, DDR3::Org> DDR3::org_map = {
+    {"DDR3_512Mb_x4", Org::DDR3_512Mb_x4}, {"DDR3_512Mb_x8", Org::DDR3_512Mb_x8}, {"DDR3_512Mb_x16", Org::DDR3_512Mb_x16},
+    {"DDR3_1Gb_x4", Org::DDR3_1Gb_x4}, {"DDR3_1Gb_x8", Org::DDR3_1Gb_x8}, {"DDR3_1Gb_x16", Org::DDR3_1Gb_x16},
+    {"DDR3_2Gb_x4", Org::DDR3_2Gb_x4}, {"DDR3_2Gb_x8", Org::DDR3_2Gb_x8}, {"DDR3_2Gb_x16", Org::DDR3_2Gb_x16},
+    {"DDR3_4Gb_x4", Org::DDR3_4Gb_x4}, {"DDR3_4Gb_x8", Org::DDR3_4Gb_x8}, {"DDR3_4Gb_x16", Org::DDR3_4Gb_x16},
+    {"DDR3_8Gb_x4", Org::DDR3_8Gb_x4}, {"DDR3_8Gb_x8", Org::DDR3_8Gb_x8}, {"DDR3_8Gb_x16", Org::DDR3_8Gb_x16},
+};
+
+map<string, DDR3::Speed> DDR3::speed_map = {
+    {"DDR3_800D", Speed::DDR3_800D}, {"DDR3_800E", Speed::DDR3_800E},
+    {"DDR3_1066E", Speed::DDR3_1066E}, {"DDR3_1066F", Speed::DDR3_1066F}, {"DDR3_1066G", Speed::DDR3_1066G},
+    {"DDR3_1333G", Speed::DDR3_1333G}, {"DDR3_1333H", Speed::DDR3_1333H},
+    {"DDR3_1600H", Speed::DDR3_1600H}, {"DDR3_1600J", Speed::DDR3_1600J}, {"DDR3_1600K", Speed::DDR3_1600K},
+    {"DDR3_1866K", Speed::DDR3_1866K}, {"DDR3_1866L", Speed::DDR3_1866L}, {"DDR3_1866M", Speed::DDR3_1866M},
+    {"DDR3_2133L", Speed::DDR3_2133L}, {"DDR3_2133M", Speed::DDR3_2133M}, {"DDR3_2133N", Speed::DDR3_2133N},
+};
+
+DDR3::DDR3(Org org, Speed speed)
+{
+    standard_name = "DDR3";
+    org_entry = org_table[int(org)];
+    speed_entry = speed_table[int(speed)];
+    prefetch_size = 8; // 8n prefetch
+    channel_width = 64;
+    read_latency = speed_entry.nCL + speed_entry.nBL;
+
+    init_speed();
+    init_prereq();
+    init_rowhit();
+    init_rowopen();
+    init_lambda();
+    init_timing();
+    init_temp_timing();
+}
+
+DDR3::DDR3(const string& org_str, const string& speed_str) :
+    DDR3(parse(org_map, org_str, "org"), parse(speed_map, speed_str, "speed"))
+{
+}
+
+
+void DDR3::init_speed()
+{
+    // ns, per speed bin (800, 1066, 1333, 1600, 1866, 2133) and page size (1KB, 2KB)
+    const static double RRD_TABLE[6][2] = {
+        {10, 10}, {7.5, 10}, {6, 7.5}, {6, 7.5}, {5, 6}, {5, 6}
+    };
+    const static double FAW_TABLE[6][2] = {
+        {40, 50}, {37.5, 50}, {30, 45}, {30, 40}, {27, 35}, {25, 35}
+    };
+    // ns, per density (512Mb, 1Gb, 2Gb, 4Gb, 8Gb)
+    const static double RFC_TABLE[5] = {90, 110, 160, 260, 350};
+
+    int speed = 0, page = 0, density = 0;
+    switch (speed_entry.rate) {
+        case 800: speed = 0; break;
+        case 1066: speed = 1; break;
+        case 1333: speed = 2; break;
+        case 1600: speed = 3; break;
+        case 1866: speed = 4; break;
+        case 2133: speed = 5; break;
+        default: assert(false);
+    };
+    switch (org_entry.dq * org_entry.count[int(Level::Column)] / 8) {
+        case 512: // x4 parts have 1KB pages as well
+        case 1024: page = 0; break;
+        case 2048: page = 1; break;
+        default: assert(false);
+    }
+    switch (org_entry.size) {
+        case 512: density = 0; break;
+        case 1<<10: density = 1; break;
+        case 2<<10: density = 2; break;
+        case 4<<10: density = 3; break;
+        case 8<<10: density = 4; break;
+        default: assert(false);
+    }
+
+    double tCK = speed_entry.tCK;
+    speed_entry.nRRDS = speed_entry.nRRDL = nck(RRD_TABLE[speed][page], tCK, 4);
+    speed_entry.nFAW = nck(FAW_TABLE[speed][page], tCK);
+    speed_entry.nRFC = nck(RFC_TABLE[density], tCK);
+    speed_entry.nREFI = nck(7800, tCK);
+    speed_entry.nXS = nck(RFC_TABLE[density] + 10, tCK, 5);
+}
+
+
+void DDR3::init_timing()
+{
+    SpeedEntry& s = speed_entry;
+    vector<TimingEntry> *t;
+
+    /*** Channel ***/
+    t = timing[int(Level::Channel)];
+
+    // CAS <-> CAS
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nBL});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nBL});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nBL});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nBL});
+    t[int(Command::WR)].push_back({Command::WR, 1, s.nBL});
+    t[int(Command::WR)].push_back({Command::WRA, 1, s.nBL});
+    t[int(Command::WRA)].push_back({Command::WR, 1, s.nBL});
+    t[int(Command::WRA)].push_back({Command::WRA, 1, s.nBL});
+
+
+    /*** Rank ***/
+    t = timing[int(Level::Rank)];
+
+    // CAS <-> CAS
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nCCDS});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nCCDS});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nCCDS});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nCCDS});
+    t[int(Command::WR)].push_back({Command::WR, 1, s.nCCDS});
+    t[int(Command::WR)].push_back({Command::WRA, 1, s.nCCDS});
+    t[int(Command::WRA)].push_back({Command::WR, 1, s.nCCDS});
+    t[int(Command::WRA)].push_back({Command::WRA, 1, s.nCCDS});
+    t[int(Command::RD)].push_back({Command::WR, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RD)].push_back({Command::WRA, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RDA)].push_back({Command::WR, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RDA)].push_back({Command::WRA, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::WR)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WR)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WRA)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WRA)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRS});
+
+    // CAS <-> CAS (between sibling ranks)
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RD)].push_back({Command::WR, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::RD)].push_back({Command::WRA, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::RDA)].push_back({Command::WR, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::RDA)].push_back({Command::WRA, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::WR)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+    t[int(Command::WR)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+    t[int(Command::WRA)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+    t[int(Command::WRA)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+
+    t[int(Command::RD)].push_back({Command::PREA, 1, s.nRTP});
+    t[int(Command::WR)].push_back({Command::PREA, 1, s.nCWL + s.nBL + s.nWR});
+
+    // CAS <-> PD
+    t[int(Command::RD)].push_back({Command::PDE, 1, s.nCL + s.nBL + 1});
+    t[int(Command::RDA)].push_back({Command::PDE, 1, s.nCL + s.nBL + 1});
+    t[int(Command::WR)].push_back({Command::PDE, 1, s.nCWL + s.nBL + s.nWR});
+    t[int(Command::WRA)].push_back({Command::PDE, 1, s.nCWL + s.nBL + s.nWR + 1}); // +1 for pre
+    t[int(Command::PDX)].push_back({Command::RD, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::RDA, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::WR, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::WRA, 1, s.nXP});
+
+    // CAS <-> SR: the DLL has to relock
+    t[int(Command::SRX)].push_back({Command::RD, 1, s.nXSDLL});
+    t[int(Command::SRX)].push_back({Command::RDA, 1, s.nXSDLL});
+    t[int(Command::SRX)].push_back({Command::WR, 1, s.nXSDLL});
+    t[int(Command::SRX)].push_back({Command::WRA, 1, s.nXSDLL});
+
+    // RAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRRDS});
+    t[int(Command::ACT)].push_back({Command::ACT, 4, s.nFAW});
+    t[int(Command::ACT)].push_back({Command::PREA, 1, s.nRAS});
+    t[int(Command::PREA)].push_back({Command::ACT, 1, s.nRP});
+
+    // RAS <-> REF
+    t[int(Command::PRE)].push_back({Command::REF, 1, s.nRP});
+    t[int(Command::PREA)].push_back({Command::REF, 1, s.nRP});
+    t[int(Command::REF)].push_back({Command::ACT, 1, s.nRFC});
+
+    // RAS <-> PD
+    t[int(Command::ACT)].push_back({Command::PDE, 1, 1});
+    t[int(Command::PDX)].push_back({Command::ACT, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::PRE, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::PREA, 1, s.nXP});
+
+    // RAS <-> SR
+    t[int(Command::PRE)].push_back({Command::SRE, 1, s.nRP});
+    t[int(Command::PREA)].push_back({Command::SRE, 1, s.nRP});
+    t[int(Command::SRX)].push_back({Command::ACT, 1, s.nXS});
+
+    // REF <-> REF
+    t[int(Command::REF)].push_back({Command::REF, 1, s.nRFC});
+
+    // REF <-> PD
+    t[int(Command::REF)].push_back({Command::PDE, 1, 1});
+    t[int(Command::PDX)].push_back({Command::REF, 1, s.nXP});
+
+    // REF <-> SR
+    t[int(Command::SRX)].push_back({Command::REF, 1, s.nXS});
+
+    // PD <-> PD
+    t[int(Command::PDE)].push_back({Command::PDX, 1, s.nPD});
+    t[int(Command::PDX)].push_back({Command::PDE, 1, s.nXP});
+
+    // PD <-> SR
+    t[int(Command::PDX)].push_back({Command::SRE, 1, s.nXP});
+    t[int(Command::SRX)].push_back({Command::PDE, 1, s.nXS});
+
+    // SR <-> SR
+    t[int(Command::SRE)].push_back({Command::SRX, 1, s.nCKESR});
+    t[int(Command::SRX)].push_back({Command::SRE, 1, s.nXS});
+
+    /*** Bank ***/
+    init_bank_timing(timing[int(Level::Bank)], s);
+}
@@ -0,0 +1,94 @@
+#ifndef __DDR3_H
+#define __DDR3_H
+
+#include "RamSpec.h"
+#include <map>
+#include <string>
+
+using namespace std;
+
+namespace ramulator
+{
+
+class DDR3 : public RamSpec
+{
+public:
+    /* Organization */
+    enum class Org : int
+    {
+        DDR3_512Mb_x4, DDR3_512Mb_x8, DDR3_512Mb_x16,
+        DDR3_1Gb_x4,   DDR3_1Gb_x8,   DDR3_1Gb_x16,
+        DDR3_2Gb_x4,   DDR3_2Gb_x8,   DDR3_2Gb_x16,
+        DDR3_4Gb_x4,   DDR3_4Gb_x8,   DDR3_4Gb_x16,
+        DDR3_8Gb_x4,   DDR3_8Gb_x8,   DDR3_8Gb_x16,
+        MAX
+    };
+    /* Speed */
+    enum class Speed : int
+    {
+        DDR3_800D,  DDR3_800E,
+        DDR3_1066E, DDR3_1066F, DDR3_1066G,
+        DDR3_1333G, DDR3_1333H,
+        DDR3_1600H, DDR3_1600J, DDR3_1600K,
+        DDR3_1866K, DDR3_1866L, DDR3_1866M,
+        DDR3_2133L, DDR3_2133M, DDR3_2133N,
+        MAX
+    };
+
+    DDR3(Org org, Speed speed);
+    DDR3(const string& org_str, const string& speed_str);
+
+    static map<string, Org> org_map;
+    static map<string, Speed> speed_map;
+
+    // 8 banks and no bank groups (a single one per rank)
+    OrgEntry org_table[int(Org::MAX)] = {
+        {  512,  4, {0, 0, 1, 1, 8, 1<<13, 1<<11}},
+        {  512,  8, {0, 0, 1, 1, 8, 1<<13, 1<<10}},
+        {  512, 16, {0, 0, 1, 1, 8, 1<<12, 1<<10}},
+        {1<<10,  4, {0, 0, 1, 1, 8, 1<<14, 1<<11}},
+        {1<<10,  8, {0, 0, 1, 1, 8, 1<<14, 1<<10}},
+        {1<<10, 16, {0, 0, 1, 1, 8, 1<<13, 1<<10}},
+        {2<<10,  4, {0, 0, 1, 1, 8, 1<<15, 1<<11}},
+        {2<<10,  8, {0, 0, 1, 1, 8, 1<<15, 1<<10}},
+        {2<<10, 16, {0, 0, 1, 1, 8, 1<<14, 1<<10}},
+        {4<<10,  4, {0, 0, 1, 1, 8, 1<<16, 1<<11}},
+        {4<<10,  8, {0, 0, 1, 1, 8, 1<<16, 1<<10}},
+        {4<<10, 16, {0, 0, 1, 1, 8, 1<<15, 1<<10}},
+        {8<<10,  4, {0, 0, 1, 1, 8, 1<<16, 1<<12}},
+        {8<<10,  8, {0, 0, 1, 1, 8, 1<<16, 1<<11}},
+        {8<<10, 16, {0, 0, 1, 1, 8, 1<<16, 1<<10}},
+    };
+
+    // The page size dependent (nRRDS, nFAW) and density dependent (nRFC, nXS)
+    // timings and nREFI are filled by init_speed(); DDR3 has no bank groups,
+    // so nCCDL, nWTRL and nRRDL equal their short counterparts
+    SpeedEntry speed_table[int(Speed::MAX)] = {
+        // rate, freq, tCK, nBL, nCCDS, nCCDL, nCL, nRCDR, nRCDW, nRP, nCWL, nRAS, nRC, nRTP, nWTRS, nWTRL, nWR,
+        // nRRDS, nRRDL, nFAW, nRFC, nREFI, nREFI1B, nPD, nXP, nCKESR, nXS, nRTRS, nXPDLL, nXSDLL
+        {800, 400, 2.5, 4, 4, 4, 5, 5, 5, 5, 5, 15, 20, 4, 4, 4, 6, 0, 0, 0, 0, 0, 0, 3, 3, 4, 0, 2, 10, 512},
+        {800, 400, 2.5, 4, 4, 4, 6, 6, 6, 6, 5, 15, 21, 4, 4, 4, 6, 0, 0, 0, 0, 0, 0, 3, 3, 4, 0, 2, 10, 512},
+        {1066, 533.333, 1.875, 4, 4, 4, 6, 6, 6, 6, 6, 20, 26, 4, 4, 4, 8, 0, 0, 0, 0, 0, 0, 3, 4, 4, 0, 2, 13, 512},
+        {1066, 533.333, 1.875, 4, 4, 4, 7, 7, 7, 7, 6, 20, 27, 4, 4, 4, 8, 0, 0, 0, 0, 0, 0, 3, 4, 4, 0, 2, 13, 512},
+        {1066, 533.333, 1.875, 4, 4, 4, 8, 8, 8, 8, 6, 20, 28, 4, 4, 4, 8, 0, 0, 0, 0, 0, 0, 3, 4, 4, 0, 2, 13, 512},
+        {1333, 666.667, 1.5, 4, 4, 4, 8, 8, 8, 8, 7, 24, 32, 5, 5, 5, 10, 0, 0, 0, 0, 0, 0, 4, 4, 5, 0, 2, 16, 512},
+        {1333, 666.667, 1.5, 4, 4, 4, 9, 9, 9, 9, 7, 24, 33, 5, 5, 5, 10, 0, 0, 0, 0, 0, 0, 4, 4, 5, 0, 2, 16, 512},
+        {1600, 800, 1.25, 4, 4, 4, 9, 9, 9, 9, 8, 28, 37, 6, 6, 6, 12, 0, 0, 0, 0, 0, 0, 4, 5, 5, 0, 2, 20, 512},
+        {1600, 800, 1.25, 4, 4, 4, 10, 10, 10, 10, 8, 28, 38, 6, 6, 6, 12, 0, 0, 0, 0, 0, 0, 4, 5, 5, 0, 2, 20, 512},
+        {1600, 800, 1.25, 4, 4, 4, 11, 11, 11, 11, 8, 28, 39, 6, 6, 6, 12, 0, 0, 0, 0, 0, 0, 4, 5, 5, 0, 2, 20, 512},
+        {1866, 933.333, 1.071, 4, 4, 4, 11, 11, 11, 11, 9, 32, 43, 7, 7, 7, 14, 0, 0, 0, 0, 0, 0, 5, 6, 6, 0, 2, 23, 512},
+        {1866, 933.333, 1.071, 4, 4, 4, 12, 12, 12, 12, 9, 32, 44, 7, 7, 7, 14, 0, 0, 0, 0, 0, 0, 5, 6, 6, 0, 2, 23, 512},
+        {1866, 933.333, 1.071, 4, 4, 4, 13, 13, 13, 13, 9, 32, 45, 7, 7, 7, 14, 0, 0, 0, 0, 0, 0, 5, 6, 6, 0, 2, 23, 512},
+        {2133, 1066.667, 0.9375, 4, 4, 4, 12, 12, 12, 12, 10, 36, 48, 8, 8, 8, 16, 0, 0, 0, 0, 0, 0, 6, 7, 7, 0, 2, 26, 512},
+        {2133, 1066.667, 0.9375, 4, 4, 4, 13, 13, 13, 13, 10, 36, 49, 8, 8, 8, 16, 0, 0, 0, 0, 0, 0, 6, 7, 7, 0, 2, 26, 512},
+        {2133, 1066.667, 0.9375, 4, 4, 4, 14, 14, 14, 14, 10, 36, 50, 8, 8, 8, 16, 0, 0, 0, 0, 0, 0, 6, 7, 7, 0, 2, 26, 512},
+    };
+
+private:
+    void init_speed();
+    void init_timing();
+};
+
+} /*namespace ramulator*/
+
+#endif /*__DDR3_H*/
@@ -0,0 +1,234 @@
+#include "DDR4.h"
+#include "RamDRAM.h"
+
+#include <vector>
+#include <functional>
+#include <cassert>
+
+using namespace std;
+using namespace ramulator;
+
+map<string, DDR4::Org> DDR4::org_map = {
+    {"DDR4_2Gb_x4", Org::DDR4_2Gb_x4}, {"DDR4_2Gb_x8", Org::DDR4_2Gb_x8}, {"DDR4_2Gb_x16", Org::DDR4_2Gb_x16},
+    {"DDR4_4Gb_x4", Org::DDR4_4Gb_x4}, {"DDR4_4Gb_x8", Org::DDR4_4Gb_x8}, {"DDR4_4Gb_x16", Org::DDR4_4Gb_x16},
+    {"DDR4_8Gb_x4", Org::DDR4_8Gb_x4}, {"DDR4_8Gb_x8", Org::DDR4_8Gb_x8}, {"DDR4_8Gb_x16", Org::DDR4_8Gb_x16},
+};
+
+map<string, DDR4::Speed> DDR4::speed_map = {
+    {"DDR4_1600J", Speed::DDR4_1600J}, {"DDR4_1600K", Speed::DDR4_1600K}, {"DDR4_1600L", Speed::DDR4_1600L},
+    {"DDR4_1866L", Speed::DDR4_1866L}, {"DDR4_1866M", Speed::DDR4_1866M}, {"DDR4_1866N", Speed::DDR4_1866N},
+    {"DDR4_2133N", Speed::DDR4_2133N}, {"DDR4_2133P", Speed::DDR4_2133P}, {"DDR4_2133R", Speed::DDR4_2133R},
+    {"DDR4_2400P", Speed::DDR4_2400P}, {"DDR4_2400R", Speed::DDR4_2400R}, {"DDR4_2400T", Speed::DDR4_2400T},
+    {"DDR4_2400U", Speed::DDR4_2400U},
+};
+
+DDR4::DDR4(Org org, Speed speed)
+{
+    standard_name = "DDR4";
+    org_entry = org_table[int(org)];
+    speed_entry = speed_table[int(speed)];
+    prefetch_size = 8; // 8n prefetch
+    channel_width = 64;
+    read_latency = speed_entry.nCL + speed_entry.nBL;
+
+    init_speed();
+    init_prereq();
+    init_rowhit();
+    init_rowopen();
+    init_lambda();
+    init_timing();
+    init_temp_timing();
+}
+
+DDR4::DDR4(const string& org_str, const string& speed_str) :
+    DDR4(parse(org_map, org_str, "org"), parse(speed_map, speed_str, "speed"))
+{
+}
+
+
+void DDR4::init_speed()
+{
+    // ns, per speed bin (1600, 1866, 2133, 2400) and page size (512B, 1KB, 2KB)
+    const static double RRDS_TABLE[4][3] = {
+        {5.0, 5.0, 6.0}, {4.2, 4.2, 5.3}, {3.7, 3.7, 5.3}, {3.3, 3.3, 5.3}
+    };
+    const static double RRDL_TABLE[4][3] = {
+        {6.0, 6.0, 7.5}, {5.3, 5.3, 6.4}, {5.3, 5.3, 6.4}, {4.9, 4.9, 6.4}
+    };
+    const static double FAW_TABLE[4][3] = {
+        {20, 25, 35}, {17, 23, 30}, {15, 21, 30}, {13, 21, 30}
+    };
+    // ns, per density (2Gb, 4Gb, 8Gb)
+    const static double RFC_TABLE[3] = {160, 260, 350};
+
+    int speed = 0, page = 0, density = 0;
+    switch (speed_entry.rate) {
+        case 1600: speed = 0; break;
+        case 1866: speed = 1; break;
+        case 2133: speed = 2; break;
+        case 2400: speed = 3; break;
+        default: assert(false);
+    };
+    switch (org_entry.dq * org_entry.count[int(Level::Column)] / 8) {
+        case 512: page = 0; break;
+        case 1024: page = 1; break;
+        case 2048: page = 2; break;
+        default: assert(false);
+    }
+    switch (org_entry.size >> 10) {
+        case 2: density = 0; break;
+        case 4: density = 1; break;
+        case 8: density = 2; break;
+        default: assert(false);
+    }
+
+    double tCK = speed_entry.tCK;
+    speed_entry.nRRDS = nck(RRDS_TABLE[speed][page], tCK, 4);
+    speed_entry.nRRDL = nck(RRDL_TABLE[speed][page], tCK, 4);
+    speed_entry.nFAW = nck(FAW_TABLE[speed][page], tCK);
+    speed_entry.nRFC = nck(RFC_TABLE[density], tCK);
+    speed_entry.nREFI = nck(7800, tCK);
+    speed_entry.nXS = nck(RFC_TABLE[density] + 10, tCK);
+}
+
+
+void DDR4::init_timing()
+{
+    SpeedEntry& s = speed_entry;
+    vector<TimingEntry> *t;
+
+    /*** Channel ***/
+    t = timing[int(Level::Channel)];
+
+    // CAS <-> CAS
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nBL});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nBL});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nBL});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nBL});
+    t[int(Command::WR)].push_back({Command::WR, 1, s.nBL});
+    t[int(Command::WR)].push_back({Command::WRA, 1, s.nBL});
+    t[int(Command::WRA)].push_back({Command::WR, 1, s.nBL});
+    t[int(Command::WRA)].push_back({Command::WRA, 1, s.nBL});
+
+
+    /*** Rank ***/
+    t = timing[int(Level::Rank)];
+
+    // CAS <-> CAS
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nCCDS});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nCCDS});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nCCDS});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nCCDS});
+    t[int(Command::WR)].push_back({Command::WR, 1, s.nCCDS});
+    t[int(Command::WR)].push_back({Command::WRA, 1, s.nCCDS});
+    t[int(Command::WRA)].push_back({Command::WR, 1, s.nCCDS});
+    t[int(Command::WRA)].push_back({Command::WRA, 1, s.nCCDS});
+    t[int(Command::RD)].push_back({Command::WR, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RD)].push_back({Command::WRA, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RDA)].push_back({Command::WR, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RDA)].push_back({Command::WRA, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::WR)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WR)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WRA)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WRA)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRS});
+
+    // CAS <-> CAS (between sibling ranks)
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nBL + s.nRTRS, true});
+    t[int(Command::RD)].push_back({Command::WR, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::RD)].push_back({Command::WRA, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::RDA)].push_back({Command::WR, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::RDA)].push_back({Command::WRA, 1, s.nCL + s.nBL + s.nRTRS - s.nCWL, true});
+    t[int(Command::WR)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+    t[int(Command::WR)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+    t[int(Command::WRA)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+    t[int(Command::WRA)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nRTRS - s.nCL, true});
+
+    t[int(Command::RD)].push_back({Command::PREA, 1, s.nRTP});
+    t[int(Command::WR)].push_back({Command::PREA, 1, s.nCWL + s.nBL + s.nWR});
+
+    // CAS <-> PD
+    t[int(Command::RD)].push_back({Command::PDE, 1, s.nCL + s.nBL + 1});
+    t[int(Command::RDA)].push_back({Command::PDE, 1, s.nCL + s.nBL + 1});
+    t[int(Command::WR)].push_back({Command::PDE, 1, s.nCWL + s.nBL + s.nWR});
+    t[int(Command::WRA)].push_back({Command::PDE, 1, s.nCWL + s.nBL + s.nWR + 1}); // +1 for pre
+    t[int(Command::PDX)].push_back({Command::RD, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::RDA, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::WR, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::WRA, 1, s.nXP});
+
+    // CAS <-> SR: the DLL has to relock
+    t[int(Command::SRX)].push_back({Command::RD, 1, s.nXSDLL});
+    t[int(Command::SRX)].push_back({Command::RDA, 1, s.nXSDLL});
+    t[int(Command::SRX)].push_back({Command::WR, 1, s.nXSDLL});
+    t[int(Command::SRX)].push_back({Command::WRA, 1, s.nXSDLL});
+
+    // RAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRRDS});
+    t[int(Command::ACT)].push_back({Command::ACT, 4, s.nFAW});
+    t[int(Command::ACT)].push_back({Command::PREA, 1, s.nRAS});
+    t[int(Command::PREA)].push_back({Command::ACT, 1, s.nRP});
+
+    // RAS <-> REF
+    t[int(Command::PRE)].push_back({Command::REF, 1, s.nRP});
+    t[int(Command::PREA)].push_back({Command::REF, 1, s.nRP});
+    t[int(Command::REF)].push_back({Command::ACT, 1, s.nRFC});
+
+    // RAS <-> PD
+    t[int(Command::ACT)].push_back({Command::PDE, 1, 1});
+    t[int(Command::PDX)].push_back({Command::ACT, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::PRE, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::PREA, 1, s.nXP});
+
+    // RAS <-> SR
+    t[int(Command::PRE)].push_back({Command::SRE, 1, s.nRP});
+    t[int(Command::PREA)].push_back({Command::SRE, 1, s.nRP});
+    t[int(Command::SRX)].push_back({Command::ACT, 1, s.nXS});
+
+    // REF <-> REF
+    t[int(Command::REF)].push_back({Command::REF, 1, s.nRFC});
+
+    // REF <-> PD
+    t[int(Command::REF)].push_back({Command::PDE, 1, 1});
+    t[int(Command::PDX)].push_back({Command::REF, 1, s.nXP});
+
+    // REF <-> SR
+    t[int(Command::SRX)].push_back({Command::REF, 1, s.nXS});
+
+    // PD <-> PD
+    t[int(Command::PDE)].push_back({Command::PDX, 1, s.nPD});
+    t[int(Command::PDX)].push_back({Command::PDE, 1, s.nXP});
+
+    // PD <-> SR
+    t[int(Command::PDX)].push_back({Command::SRE, 1, s.nXP});
+    t[int(Command::SRX)].push_back({Command::PDE, 1, s.nXS});
+
+    // SR <-> SR
+    t[int(Command::SRE)].push_back({Command::SRX, 1, s.nCKESR});
+    t[int(Command::SRX)].push_back({Command::SRE, 1, s.nXS});
+
+    /*** Bank Group ***/
+    t = timing[int(Level::BankGroup)];
+
+    // CAS <-> CAS
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nCCDL});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nCCDL});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nCCDL});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nCCDL});
+    t[int(Command::WR)].push_back({Command::WR, 1, s.nCCDL});
+    t[int(Command::WR)].push_back({Command::WRA, 1, s.nCCDL});
+    t[int(Command::WRA)].push_back({Command::WR, 1, s.nCCDL});
+    t[int(Command::WRA)].push_back({Command::WRA, 1, s.nCCDL});
+    t[int(Command::WR)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRL});
+    t[int(Command::WR)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRL});
+    t[int(Command::WRA)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRL});
+    t[int(Command::WRA)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRL});
+
+    // RAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRRDL});
+
+    /*** Bank ***/
+    init_bank_timing(timing[int(Level::Bank)], s);
+}
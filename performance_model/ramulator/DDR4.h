@@ -0,0 +1,80 @@
+#ifndef __DDR4_H
+#define __DDR4_H
+
+#include "RamSpec.h"
+#include <map>
+#include <string>
+
+using namespace std;
+
+namespace ramulator
+{
+
+class DDR4 : public RamSpec
+{
+public:
+    /* Organization */
+    enum class Org : int
+    {
+        DDR4_2Gb_x4, DDR4_2Gb_x8, DDR4_2Gb_x16,
+        DDR4_4Gb_x4, DDR4_4Gb_x8, DDR4_4Gb_x16,
+        DDR4_8Gb_x4, DDR4_8Gb_x8, DDR4_8Gb_x16,
+        MAX
+    };
+    /* Speed */
+    enum class Speed : int
+    {
+        DDR4_1600J, DDR4_1600K, DDR4_1600L,
+        DDR4_1866L, DDR4_1866M, DDR4_1866N,
+        DDR4_2133N, DDR4_2133P, DDR4_2133R,
+        DDR4_2400P, DDR4_2400R, DDR4_2400T, DDR4_2400U,
+        MAX
+    };
+
+    DDR4(Org org, Speed speed);
+    DDR4(const string& org_str, const string& speed_str);
+
+    static map<string, Org> org_map;
+    static map<string, Speed> speed_map;
+
+    // x4 and x8 parts have 4 bank groups of 4 banks, x16 parts 2 of 4
+    OrgEntry org_table[int(Org::MAX)] = {
+        {2<<10,  4, {0, 0, 1, 4, 4, 1<<15, 1<<10}},
+        {2<<10,  8, {0, 0, 1, 4, 4, 1<<14, 1<<10}},
+        {2<<10, 16, {0, 0, 1, 2, 4, 1<<14, 1<<10}},
+        {4<<10,  4, {0, 0, 1, 4, 4, 1<<16, 1<<10}},
+        {4<<10,  8, {0, 0, 1, 4, 4, 1<<15, 1<<10}},
+        {4<<10, 16, {0, 0, 1, 2, 4, 1<<15, 1<<10}},
+        {8<<10,  4, {0, 0, 1, 4, 4, 1<<17, 1<<10}},
+        {8<<10,  8, {0, 0, 1, 4, 4, 1<<16, 1<<10}},
+        {8<<10, 16, {0, 0, 1, 2, 4, 1<<16, 1<<10}},
+    };
+
+    // The page size dependent (nRRDS, nRRDL, nFAW) and density dependent
+    // (nRFC, nXS) timings and nREFI are filled by init_speed()
+    SpeedEntry speed_table[int(Speed::MAX)] = {
+        // rate, freq, tCK, nBL, nCCDS, nCCDL, nCL, nRCDR, nRCDW, nRP, nCWL, nRAS, nRC, nRTP, nWTRS, nWTRL, nWR,
+        // nRRDS, nRRDL, nFAW, nRFC, nREFI, nREFI1B, nPD, nXP, nCKESR, nXS, nRTRS, nXPDLL, nXSDLL
+        {1600, 800, 1.25, 4, 4, 5, 10, 10, 10, 10, 9, 28, 38, 6, 2, 6, 12, 0, 0, 0, 0, 0, 0, 4, 5, 5, 0, 2, 20, 597},
+        {1600, 800, 1.25, 4, 4, 5, 11, 11, 11, 11, 9, 28, 39, 6, 2, 6, 12, 0, 0, 0, 0, 0, 0, 4, 5, 5, 0, 2, 20, 597},
+        {1600, 800, 1.25, 4, 4, 5, 12, 12, 12, 12, 9, 28, 40, 6, 2, 6, 12, 0, 0, 0, 0, 0, 0, 4, 5, 5, 0, 2, 20, 597},
+        {1866, 933.333, 1.071, 4, 4, 5, 12, 12, 12, 12, 10, 32, 44, 7, 3, 7, 14, 0, 0, 0, 0, 0, 0, 5, 6, 6, 0, 2, 23, 597},
+        {1866, 933.333, 1.071, 4, 4, 5, 13, 13, 13, 13, 10, 32, 45, 7, 3, 7, 14, 0, 0, 0, 0, 0, 0, 5, 6, 6, 0, 2, 23, 597},
+        {1866, 933.333, 1.071, 4, 4, 5, 14, 14, 14, 14, 10, 32, 46, 7, 3, 7, 14, 0, 0, 0, 0, 0, 0, 5, 6, 6, 0, 2, 23, 597},
+        {2133, 1066.667, 0.9375, 4, 4, 6, 14, 14, 14, 14, 11, 36, 50, 8, 3, 8, 16, 0, 0, 0, 0, 0, 0, 6, 7, 7, 0, 2, 26, 768},
+        {2133, 1066.667, 0.9375, 4, 4, 6, 15, 15, 15, 15, 11, 36, 51, 8, 3, 8, 16, 0, 0, 0, 0, 0, 0, 6, 7, 7, 0, 2, 26, 768},
+        {2133, 1066.667, 0.9375, 4, 4, 6, 16, 16, 16, 16, 11, 36, 52, 8, 3, 8, 16, 0, 0, 0, 0, 0, 0, 6, 7, 7, 0, 2, 26, 768},
+        {2400, 1200, 0.833, 4, 4, 6, 15, 15, 15, 15, 12, 39, 54, 9, 3, 9, 18, 0, 0, 0, 0, 0, 0, 6, 8, 7, 0, 2, 29, 768},
+        {2400, 1200, 0.833, 4, 4, 6, 16, 16, 16, 16, 12, 39, 55, 9, 3, 9, 18, 0, 0, 0, 0, 0, 0, 6, 8, 7, 0, 2, 29, 768},
+        {2400, 1200, 0.833, 4, 4, 6, 17, 17, 17, 17, 12, 39, 56, 9, 3, 9, 18, 0, 0, 0, 0, 0, 0, 6, 8, 7, 0, 2, 29, 768},
+        {2400, 1200, 0.833, 4, 4, 6, 18, 18, 18, 18, 12, 39, 57, 9, 3, 9, 18, 0, 0, 0, 0, 0, 0, 6, 8, 7, 0, 2, 29, 768},
+    };
+
+private:
+    void init_speed();
+    void init_timing();
+};
+
+} /*namespace ramulator*/
+
+#endif /*__DDR4_H*/
@@ -8,44 +8,39 @@
 using namespace std;
 using namespace ramulator;
 
-string HBM::standard_name = "HBM";
-
-map<string, Org> HBM::org_map = {
+map<string, HBM::Org> HBM::org_map = {
     {"HBM_1Gb", Org::HBM_1Gb},
     {"HBM_2Gb", Org::HBM_2Gb},
     {"HBM_4Gb", Org::HBM_4Gb},
 };
 
-map<string, Speed> HBM::speed_map = {
+map<string, HBM::Speed> HBM::speed_map = {
     {"HBM_1Gbps", Speed::HBM_1Gbps},
 };
 
 HBM::HBM(Org org, Speed speed)
-    : org_entry(org_table[int(org)]),
-    speed_entry(speed_table[int(speed)]),
-    read_latency(speed_entry.nCL + speed_entry.nBL)
 {
+    standard_name = "HBM";
+    org_entry = org_table[int(org)];
+    speed_entry = speed_table[int(speed)];
+    prefetch_size = 4; // burst length could be 2 and 4 (choose 4 here), 2n prefetch
+    channel_width = 128;
+    read_latency = speed_entry.nCL + speed_entry.nBL;
+
     init_speed();
     init_prereq();
     init_rowhit(); // SAUGATA: added row hit function
     init_rowopen();
     init_lambda();
     init_timing();
+    init_temp_timing();
 }
 
 HBM::HBM(const string& org_str, const string& speed_str) :
-    HBM(org_map[org_str], speed_map[speed_str])
+    HBM(parse(org_map, org_str, "org"), parse(speed_map, speed_str, "speed"))
 {
 }
 
-void HBM::set_channel_number(int channel) {
-  org_entry.count[int(Level::Channel)] = channel;
-}
-
-void HBM::set_rank_number(int rank) {
-  org_entry.count[int(Level::Rank)] = rank;
-}
-
 
 void HBM::init_speed()
 {
@@ -78,138 +73,14 @@ void HBM::init_speed()
 
 void HBM::init_prereq()
 {
-    // RD
-    prereq[int(Level::Rank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
-        switch (int(node->state)) {
-            case int(State::PowerUp): return Command::MAX;
-            case int(State::ActPowerDown): return Command::PDX;
-            case int(State::PrePowerDown): return Command::PDX;
-            case int(State::SelfRefresh): return Command::SRX;
-            default: assert(false);
-        }};
-    prereq[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
-        switch (int(node->state)) {
-            case int(State::Closed): return Command::ACT;
-            case int(State::Opened):
-                if (node->row_state.find(id) != node->row_state.end())
-                    return cmd;
-                else return Command::PRE;
-            default: assert(false);
-        }};
-
-    // WR
-    prereq[int(Level::Rank)][int(Command::WR)] = prereq[int(Level::Rank)][int(Command::RD)];
-    prereq[int(Level::Bank)][int(Command::WR)] = prereq[int(Level::Bank)][int(Command::RD)];
-
-    // REF
-    prereq[int(Level::Rank)][int(Command::REF)] = [] (RamDRAM* node, Command cmd, int id) {
-        for (auto bg : node->children)
-            for (auto bank: bg->children) {
-                if (bank->state == State::Closed)
-                    continue;
-                return Command::PREA;
-            }
-        return Command::REF;};
+    RamSpec::init_prereq();
 
     // REFSB
     prereq[int(Level::Bank)][int(Command::REFSB)] = [] (RamDRAM* node, Command cmd, int id) {
         if (node->state == State::Closed) return Command::REFSB;
         return Command::PRE;};
-
-    // PD
-    prereq[int(Level::Rank)][int(Command::PDE)] = [] (RamDRAM* node, Command cmd, int id) {
-        switch (int(node->state)) {
-            case int(State::PowerUp): return Command::PDE;
-            case int(State::ActPowerDown): return Command::PDE;
-            case int(State::PrePowerDown): return Command::PDE;
-            case int(State::SelfRefresh): return Command::SRX;
-            default: assert(false);
-        }};
-
-    // SR
-    prereq[int(Level::Rank)][int(Command::SRE)] = [] (RamDRAM* node, Command cmd, int id) {
-        switch (int(node->state)) {
-            case int(State::PowerUp): return Command::SRE;
-            case int(State::ActPowerDown): return Command::PDX;
-            case int(State::PrePowerDown): return Command::PDX;
-            case int(State::SelfRefresh): return Command::SRE;
-            default: assert(false);
-        }};
-}
-
-// SAUGATA: added row hit check functions to see if the desired location is currently open
-void HBM::init_rowhit()
-{
-    // RD
-    rowhit[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
-        switch (int(node->state)) {
-            case int(State::Closed): return false;
-            case int(State::Opened):
-                if (node->row_state.find(id) != node->row_state.end())
-                    return true;
-                return false;
-            default: assert(false);
-        }};
-
-    // WR
-    rowhit[int(Level::Bank)][int(Command::WR)] = rowhit[int(Level::Bank)][int(Command::RD)];
 }
 
-void HBM::init_rowopen()
-{
-    // RD
-    rowopen[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
-        switch (int(node->state)) {
-            case int(State::Closed): return false;
-            case int(State::Opened): return true;
-            default: assert(false);
-        }};
-
-    // WR
-    rowopen[int(Level::Bank)][int(Command::WR)] = rowopen[int(Level::Bank)][int(Command::RD)];
-}
-
-void HBM::init_lambda()
-{
-    lambda[int(Level::Bank)][int(Command::ACT)] = [] (RamDRAM* node, int id) {
-        node->state = State::Opened;
-        node->row_state[id] = State::Opened;};
-    lambda[int(Level::Bank)][int(Command::PRE)] = [] (RamDRAM* node, int id) {
-        node->state = State::Closed;
-        node->row_state.clear();};
-    lambda[int(Level::Rank)][int(Command::PREA)] = [] (RamDRAM* node, int id) {
-        for (auto bg : node->children)
-            for (auto bank : bg->children) {
-                bank->state = State::Closed;
-                bank->row_state.clear();
-            }};
-    lambda[int(Level::Rank)][int(Command::REF)] = [] (RamDRAM* node, int id) {};
-    lambda[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, int id) {};
-    lambda[int(Level::Bank)][int(Command::WR)] = [] (RamDRAM* node, int id) {};
-    lambda[int(Level::Bank)][int(Command::RDA)] = [] (RamDRAM* node, int id) {
-        node->state = State::Closed;
-        node->row_state.clear();};
-    lambda[int(Level::Bank)][int(Command::WRA)] = [] (RamDRAM* node, int id) {
-        node->state = State::Closed;
-        node->row_state.clear();};
-    lambda[int(Level::Rank)][int(Command::PDE)] = [] (RamDRAM* node, int id) {
-        for (auto bg : node->children)
-            for (auto bank : bg->children) {
-                if (bank->state == State::Closed)
-                    continue;
-                node->state = State::ActPowerDown;
-                return;
-            }
-        node->state = State::PrePowerDown;};
-    lambda[int(Level::Rank)][int(Command::PDX)] = [] (RamDRAM* node, int id) {
-        node->state = State::PowerUp;};
-    lambda[int(Level::Rank)][int(Command::SRE)] = [] (RamDRAM* node, int id) {
-        node->state = State::SelfRefresh;};
-    lambda[int(Level::Rank)][int(Command::SRX)] = [] (RamDRAM* node, int id) {
-        node->state = State::PowerUp;};
-}
-
-
 void HBM::init_timing()
 {
     SpeedEntry& s = speed_entry;
@@ -310,7 +181,7 @@ void HBM::init_timing()
     t[int(Command::SRX)].push_back({Command::SRE, 1, s.nXS});
 
     /*** Bank Group ***/
-    //t = timing[int(Level::BankGroup)];
+    t = timing[int(Level::BankGroup)];
     // CAS <-> CAS
 	/*
     t[int(Command::RD)].push_back({Command::RD, 1, s.nCCDL});
@@ -334,24 +205,12 @@ void HBM::init_timing()
     t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRRDL});
 
     /*** Bank ***/
-    t = timing[int(Level::Bank)];
-
-    // CAS <-> RAS
-    t[int(Command::ACT)].push_back({Command::RD, 1, s.nRCDR});
-    t[int(Command::ACT)].push_back({Command::RDA, 1, s.nRCDR});
-    t[int(Command::ACT)].push_back({Command::WR, 1, s.nRCDW});
-    t[int(Command::ACT)].push_back({Command::WRA, 1, s.nRCDW});
-
-    t[int(Command::RD)].push_back({Command::PRE, 1, s.nRTP});
-    t[int(Command::WR)].push_back({Command::PRE, 1, s.nCWL + s.nBL + s.nWR});
-
-    t[int(Command::RDA)].push_back({Command::ACT, 1, s.nRTP + s.nRP});
-    t[int(Command::WRA)].push_back({Command::ACT, 1, s.nCWL + s.nBL + s.nWR + s.nRP});
+    init_bank_timing(timing[int(Level::Bank)], s);
+}
 
-    // RAS <-> RAS
-    t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRC});
-    t[int(Command::ACT)].push_back({Command::PRE, 1, s.nRAS});
-    t[int(Command::PRE)].push_back({Command::ACT, 1, s.nRP});
+void HBM::init_bank_timing(vector<TimingEntry>* t, const SpeedEntry& s)
+{
+    RamSpec::init_bank_timing(t, s);
 
     // REFSB
     t[int(Command::PRE)].push_back({Command::REFSB, 1, s.nRP});
@@ -1,44 +1,18 @@
 #ifndef __HBM_H
 #define __HBM_H
 
-#include "RamDRAM.h"
-#include "RamRequest.h"
-#include <vector>
-#include <functional>
-
-#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#include "RamSpec.h"
+#include <map>
+#include <string>
 
 using namespace std;
 
 namespace ramulator
 {
-    /* Level */
-    enum class Level : int
-    {
-        Channel, Rank, Bank, Row, Column, MAX
-    };
 
-    /* Command */
-    enum class Command : int
-    {
-        ACT, PRE,   PREA,
-        RD,  WR,    RDA, WRA,
-        REF, REFSB, PDE, PDX,  SRE, SRX,
-        MAX
-    };
-    /* State */
-    enum class State : int
-    {
-        Opened, Closed, PowerUp, ActPowerDown, PrePowerDown, SelfRefresh, MAX
-    };
-    /* Timing */
-    struct TimingEntry
-    {
-        Command cmd;
-        int dist;
-        int val;
-        bool sibling;
-    };
+class HBM : public RamSpec
+{
+public:
     /* Organization */
     enum class Org : int
     { // per channel density here. Each stack comes with 8 channels
@@ -53,12 +27,7 @@ namespace ramulator
         HBM_1Gbps,
         MAX
     };
-class RamDRAM;
 
-class HBM
-{
-public:
-    static string standard_name;
     HBM(Org org, Speed speed);
     HBM(const string& org_str, const string& speed_str);
 
@@ -70,131 +39,21 @@ public:
     // REFSB can be issued to banks in any order, as long as REFI1B
     // is satisfied for all banks
 
-    string command_name[int(Command::MAX)] = {
-        "ACT", "PRE",   "PREA",
-        "RD",  "WR",    "RDA",  "WRA",
-        "REF", "REFSB", "PDE",  "PDX",  "SRE", "SRX"
-    };
-
-    Level scope[int(Command::MAX)] = {
-        Level::Row,    Level::Bank,   Level::Rank,
-        Level::Column, Level::Column, Level::Column, Level::Column,
-        Level::Rank,   Level::Bank,   Level::Rank,   Level::Rank,   Level::Rank,   Level::Rank
+    OrgEntry org_table[int(Org::MAX)] = {
+        {1<<10, 128, {0, 0, 1, 1, 2, 1<<13, 1<<(6+1)}},
+        {2<<10, 128, {0, 0, 1, 1, 2, 1<<14, 1<<(6+1)}},
+        {4<<10, 128, {0, 0, 1, 1, 2, 1<<11, 1<<(12+1)}},
     };
 
-    bool is_opening(Command cmd)
-    {
-        switch(int(cmd)) {
-            case int(Command::ACT):
-                return true;
-            default:
-                return false;
-        }
-    }
-
-    bool is_accessing(Command cmd)
-    {
-        switch(int(cmd)) {
-            case int(Command::RD):
-            case int(Command::WR):
-            case int(Command::RDA):
-            case int(Command::WRA):
-                return true;
-            default:
-                return false;
-        }
-    }
-
-    bool is_closing(Command cmd)
-    {
-        switch(int(cmd)) {
-            case int(Command::RDA):
-            case int(Command::WRA):
-            case int(Command::PRE):
-            case int(Command::PREA):
-                return true;
-            default:
-                return false;
-        }
-    }
-
-    bool is_refreshing(Command cmd)
-    {
-        switch(int(cmd)) {
-            case int(Command::REF):
-            case int(Command::REFSB):
-                return true;
-            default:
-                return false;
-        }
-    }
-
-    /* State */
-    State start[int(Level::MAX)] = {
-        State::MAX, State::PowerUp, State::Closed, State::Closed, State::MAX
-    };
-
-    /* Translate */
-    Command translate[int(RamRequest::Type::MAX)] = {
-        Command::RD,  Command::WR,
-        Command::REF, Command::PDE, Command::SRE
-    };
-
-    /* Prereq */
-    function<Command(RamDRAM*, Command cmd, int)> prereq[int(Level::MAX)][int(Command::MAX)];
-
-    // SAUGATA: added function object container for row hit status
-    /* Row hit */
-    function<bool(RamDRAM*, Command cmd, int)> rowhit[int(Level::MAX)][int(Command::MAX)];
-    function<bool(RamDRAM*, Command cmd, int)> rowopen[int(Level::MAX)][int(Command::MAX)];
-
-    vector<TimingEntry> timing[int(Level::MAX)][int(Command::MAX)];
-
-    /* Lambda */
-    function<void(RamDRAM*, int)> lambda[int(Level::MAX)][int(Command::MAX)];
-
-
-    struct OrgEntry {
-        int size;
-        int dq;
-        int count[int(Level::MAX)];
-    } org_table[int(Org::MAX)] = {
-        {1<<10, 128, {0, 0, 2, 1<<13, 1<<(6+1)}},
-        {2<<10, 128, {0, 0, 2, 1<<14, 1<<(6+1)}},
-        {4<<10, 128, {0, 0, 2, 1<<11, 1<<(12+1)}},
-    }, org_entry;
-
-    void set_channel_number(int channel);
-    void set_rank_number(int rank);
-
-
-    int prefetch_size = 4; // burst length could be 2 and 4 (choose 4 here), 2n prefetch
-    int channel_width = 128;
-
-    struct SpeedEntry {
-        int rate;
-        double freq, tCK;
-        int nBL, nCCDS, nCCDL;
-        int nCL, nRCDR, nRCDW, nRP, nCWL;
-        int nRAS, nRC;
-        int nRTP, nWTRS, nWTRL, nWR;
-        int nRRDS, nRRDL, nFAW;
-        int nRFC, nREFI, nREFI1B;
-        int nPD, nXP;
-        int nCKESR, nXS;
-    } speed_table[int(Speed::MAX)] = {
+    SpeedEntry speed_table[int(Speed::MAX)] = {
         {1000, 500, 2.0, 2, 2, 3, 7, 7, 6, 7, 4, 17, 24, 7, 2, 4, 8, 4, 5, 20, 0, 3900, 0, 5, 5, 5, 0}
-    }, speed_entry;
-
-    int read_latency;
+    };
 
 private:
     void init_speed();
-    void init_lambda();
     void init_prereq();
-    void init_rowhit();  // SAUGATA: added function to check for row hits
-    void init_rowopen();
     void init_timing();
+    void init_bank_timing(vector<TimingEntry>* t, const SpeedEntry& s);
 };
 
 } /*namespace ramulator*/
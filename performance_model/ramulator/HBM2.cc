@@ -0,0 +1,237 @@
+#include "HBM2.h"
+#include "RamDRAM.h"
+
+#include <vector>
+#include <functional>
+#include <cassert>
+
+using namespace std;
+using namespace ramulator;
+
+map<string, HBM2::Org> HBM2::org_map = {
+    {"HBM2_2Gb", Org::HBM2_2Gb},
+    {"HBM2_4Gb", Org::HBM2_4Gb},
+    {"HBM2_8Gb", Org::HBM2_8Gb},
+    {"HBM2E_16Gb", Org::HBM2E_16Gb},
+};
+
+map<string, HBM2::Speed> HBM2::speed_map = {
+    {"HBM2_1600", Speed::HBM2_1600},
+    {"HBM2_2000", Speed::HBM2_2000},
+    {"HBM2_2400", Speed::HBM2_2400},
+    {"HBM2E_2800", Speed::HBM2E_2800},
+    {"HBM2E_3200", Speed::HBM2E_3200},
+    {"HBM2E_3600", Speed::HBM2E_3600},
+};
+
+HBM2::HBM2(Org org, Speed speed)
+{
+    standard_name = "HBM2";
+    org_entry = org_table[int(org)];
+    speed_entry = speed_table[int(speed)];
+    prefetch_size = 4; // BL4 on a pseudo channel
+    channel_width = 64; // of a pseudo channel
+    // a refresh targeting one bank only blocks that bank
+    translate[int(RamRequest::Type::BANKREFRESH)] = Command::REFSB;
+
+    init_speed();
+    read_latency = speed_entry.nCL + speed_entry.nBL;
+
+    init_prereq();
+    init_rowhit();
+    init_rowopen();
+    init_lambda();
+    init_timing();
+    init_temp_timing();
+}
+
+HBM2::HBM2(const string& org_str, const string& speed_str) :
+    HBM2(parse(org_map, org_str, "org"), parse(speed_map, speed_str, "speed"))
+{
+}
+
+
+void HBM2::init_speed()
+{
+    // ns, per channel density (2Gb, 4Gb, 8Gb, 16Gb)
+    const static double RFC_TABLE[int(Org::MAX)] = {160, 260, 350, 450};
+    const static double RFCSB_TABLE[int(Org::MAX)] = {90, 110, 160, 200};
+
+    int density = 0;
+    switch (org_entry.size >> 10) {
+        case 2: density = 0; break;
+        case 4: density = 1; break;
+        case 8: density = 2; break;
+        case 16: density = 3; break;
+        default: assert(false);
+    }
+
+    SpeedEntry& s = speed_entry;
+    double tCK = s.tCK;
+    s.nCL = nck(14, tCK);
+    s.nRCDR = nck(14, tCK);
+    s.nRCDW = nck(10, tCK);
+    s.nRP = nck(14, tCK);
+    s.nCWL = nck(4, tCK, 2);
+    s.nRAS = nck(33, tCK);
+    s.nRC = s.nRAS + s.nRP;
+    s.nRTP = nck(7.5, tCK, 2);
+    s.nWTRS = nck(2.5, tCK, 2);
+    s.nWTRL = nck(7.5, tCK, 4);
+    s.nWR = nck(15, tCK);
+    s.nRRDS = nck(4, tCK, 2);
+    s.nRRDL = nck(6, tCK, 4);
+    s.nFAW = nck(16, tCK);
+    s.nRFC = nck(RFC_TABLE[density], tCK);
+    s.nRFCSB = nck(RFCSB_TABLE[density], tCK);
+    s.nREFI = nck(3900, tCK);
+    // all banks of a rank take their turn within nREFI
+    s.nREFI1B = s.nREFI / banks_per_rank();
+    s.nPD = nck(5, tCK, 3);
+    s.nXP = nck(7.5, tCK, 3);
+    s.nCKESR = s.nPD + 1;
+    s.nXS = nck(RFC_TABLE[density] + 10, tCK);
+}
+
+
+void HBM2::init_prereq()
+{
+    RamSpec::init_prereq();
+
+    // REFSB
+    prereq[int(Level::Rank)][int(Command::REFSB)] = prereq[int(Level::Rank)][int(Command::RD)];
+    prereq[int(Level::Bank)][int(Command::REFSB)] = [] (RamDRAM* node, Command cmd, int id) {
+        if (node->state == State::Closed) return Command::REFSB;
+        return Command::PRE;};
+}
+
+void HBM2::init_timing()
+{
+    SpeedEntry& s = speed_entry;
+    vector<TimingEntry> *t;
+
+    /*** Rank ***/
+    t = timing[int(Level::Rank)];
+
+    t[int(Command::RD)].push_back({Command::PREA, 1, s.nRTP});
+    t[int(Command::WR)].push_back({Command::PREA, 1, s.nCWL + s.nBL + s.nWR});
+
+    // CAS <-> PD
+    t[int(Command::RD)].push_back({Command::PDE, 1, s.nCL + s.nBL + 1});
+    t[int(Command::RDA)].push_back({Command::PDE, 1, s.nCL + s.nBL + 1});
+    t[int(Command::WR)].push_back({Command::PDE, 1, s.nCWL + s.nBL + s.nWR});
+    t[int(Command::WRA)].push_back({Command::PDE, 1, s.nCWL + s.nBL + s.nWR + 1}); // +1 for pre
+    t[int(Command::PDX)].push_back({Command::RD, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::RDA, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::WR, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::WRA, 1, s.nXP});
+
+    // CAS <-> SR: none (all banks have to be precharged)
+
+    // RAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::PREA, 1, s.nRAS});
+    t[int(Command::PREA)].push_back({Command::ACT, 1, s.nRP});
+
+    // RAS <-> REF
+    t[int(Command::PRE)].push_back({Command::REF, 1, s.nRP});
+    t[int(Command::PREA)].push_back({Command::REF, 1, s.nRP});
+    t[int(Command::REF)].push_back({Command::ACT, 1, s.nRFC});
+
+    // RAS <-> PD
+    t[int(Command::ACT)].push_back({Command::PDE, 1, 1});
+    t[int(Command::PDX)].push_back({Command::ACT, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::PRE, 1, s.nXP});
+    t[int(Command::PDX)].push_back({Command::PREA, 1, s.nXP});
+
+    // RAS <-> SR
+    t[int(Command::PRE)].push_back({Command::SRE, 1, s.nRP});
+    t[int(Command::PREA)].push_back({Command::SRE, 1, s.nRP});
+    t[int(Command::SRX)].push_back({Command::ACT, 1, s.nXS});
+
+    // REF <-> REF
+    t[int(Command::REF)].push_back({Command::REF, 1, s.nRFC});
+    t[int(Command::REF)].push_back({Command::REFSB, 1, s.nRFC});
+    t[int(Command::REFSB)].push_back({Command::REF, 1, s.nRFCSB});
+
+    // REF <-> PD
+    t[int(Command::REF)].push_back({Command::PDE, 1, 1});
+    t[int(Command::PDX)].push_back({Command::REF, 1, s.nXP});
+
+    // REF <-> SR
+    t[int(Command::SRX)].push_back({Command::REF, 1, s.nXS});
+
+    // PD <-> PD
+    t[int(Command::PDE)].push_back({Command::PDX, 1, s.nPD});
+    t[int(Command::PDX)].push_back({Command::PDE, 1, s.nXP});
+
+    // PD <-> SR
+    t[int(Command::PDX)].push_back({Command::SRE, 1, s.nXP});
+    t[int(Command::SRX)].push_back({Command::PDE, 1, s.nXS});
+
+    // SR <-> SR
+    t[int(Command::SRE)].push_back({Command::SRX, 1, s.nCKESR});
+    t[int(Command::SRX)].push_back({Command::SRE, 1, s.nXS});
+
+    /*** Pseudo Channel ***/
+    t = timing[int(Level::PseudoChannel)];
+
+    // CAS <-> CAS
+    t[int(Command::RD)].push_back({Command::RD, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::RD)].push_back({Command::RDA, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::RDA)].push_back({Command::RD, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::WR)].push_back({Command::WR, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::WR)].push_back({Command::WRA, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::WRA)].push_back({Command::WR, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::WRA)].push_back({Command::WRA, 1, max(s.nBL, s.nCCDS)});
+    t[int(Command::RD)].push_back({Command::WR, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RD)].push_back({Command::WRA, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RDA)].push_back({Command::WR, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::RDA)].push_back({Command::WRA, 1, s.nCL + s.nBL + 2 - s.nCWL});
+    t[int(Command::WR)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WR)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WRA)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRS});
+    t[int(Command::WRA)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRS});
+
+    // RAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRRDS});
+    t[int(Command::ACT)].push_back({Command::ACT, 4, s.nFAW});
+
+    // RAS <-> REFSB
+    t[int(Command::ACT)].push_back({Command::REFSB, 1, s.nRRDS});
+    t[int(Command::REFSB)].push_back({Command::ACT, 1, s.nRRDS});
+    t[int(Command::REFSB)].push_back({Command::REFSB, 1, s.nRRDS});
+
+    /*** Bank Group ***/
+    t = timing[int(Level::BankGroup)];
+
+    // CAS <-> CAS
+    t[int(Command::RD)].push_back({Command::RD, 1, s.nCCDL});
+    t[int(Command::RD)].push_back({Command::RDA, 1, s.nCCDL});
+    t[int(Command::RDA)].push_back({Command::RD, 1, s.nCCDL});
+    t[int(Command::RDA)].push_back({Command::RDA, 1, s.nCCDL});
+    t[int(Command::WR)].push_back({Command::WR, 1, s.nCCDL});
+    t[int(Command::WR)].push_back({Command::WRA, 1, s.nCCDL});
+    t[int(Command::WRA)].push_back({Command::WR, 1, s.nCCDL});
+    t[int(Command::WRA)].push_back({Command::WRA, 1, s.nCCDL});
+    t[int(Command::WR)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRL});
+    t[int(Command::WR)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRL});
+    t[int(Command::WRA)].push_back({Command::RD, 1, s.nCWL + s.nBL + s.nWTRL});
+    t[int(Command::WRA)].push_back({Command::RDA, 1, s.nCWL + s.nBL + s.nWTRL});
+
+    // RAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRRDL});
+
+    /*** Bank ***/
+    init_bank_timing(timing[int(Level::Bank)], s);
+}
+
+void HBM2::init_bank_timing(vector<TimingEntry>* t, const SpeedEntry& s)
+{
+    RamSpec::init_bank_timing(t, s);
+
+    // REFSB
+    t[int(Command::PRE)].push_back({Command::REFSB, 1, s.nRP});
+    t[int(Command::REFSB)].push_back({Command::REFSB, 1, s.nRFCSB});
+    t[int(Command::REFSB)].push_back({Command::ACT, 1, s.nRFCSB});
+}
@@ -0,0 +1,80 @@
+#ifndef __HBM2_H
+#define __HBM2_H
+
+#include "RamSpec.h"
+#include <map>
+#include <string>
+
+using namespace std;
+
+namespace ramulator
+{
+
+/*
+ * HBM2 and HBM2E in pseudo channel mode
+ *   Each 128-bit channel is split into two 64-bit pseudo channels which
+ *   share the command bus but have their own data bus and banks, so the
+ *   data bus, tCCD_S, tWTR_S, tRRD_S and tFAW constraints are kept per
+ *   pseudo channel. Banks are grouped in 4 bank groups: back-to-back
+ *   accesses to the same group wait tCCD_L, tWTR_L and tRRD_L.
+ */
+class HBM2 : public RamSpec
+{
+public:
+    /* Organization */
+    enum class Org : int
+    { // per channel density, as for HBM
+        HBM2_2Gb,
+        HBM2_4Gb,
+        HBM2_8Gb,
+        HBM2E_16Gb,
+        MAX
+    };
+    /* Speed */
+    enum class Speed : int
+    { // data rate per pin in Mbps
+        HBM2_1600,
+        HBM2_2000,
+        HBM2_2400,
+        HBM2E_2800,
+        HBM2E_3200,
+        HBM2E_3600,
+        MAX
+    };
+
+    HBM2(Org org, Speed speed);
+    HBM2(const string& org_str, const string& speed_str);
+
+    static map<string, Org> org_map;
+    static map<string, Speed> speed_map;
+
+    // 2 pseudo channels of 4 bank groups of 4 banks, 1KB pages
+    OrgEntry org_table[int(Org::MAX)] = {
+        {2<<10,  64, {0, 0, 2, 4, 4, 1<<13, 1<<7}},
+        {4<<10,  64, {0, 0, 2, 4, 4, 1<<14, 1<<7}},
+        {8<<10,  64, {0, 0, 2, 4, 4, 1<<15, 1<<7}},
+        {16<<10, 64, {0, 0, 2, 4, 4, 1<<16, 1<<7}},
+    };
+
+    // The core timings are the same in ns across the speed bins and are
+    // converted to cycles by init_speed(); a BL4 burst takes 2 cycles
+    SpeedEntry speed_table[int(Speed::MAX)] = {
+        // rate, freq, tCK, nBL, nCCDS, nCCDL
+        {1600, 800, 1.25, 2, 2, 4},
+        {2000, 1000, 1.0, 2, 2, 4},
+        {2400, 1200, 0.833, 2, 2, 4},
+        {2800, 1400, 0.714, 2, 2, 4},
+        {3200, 1600, 0.625, 2, 2, 4},
+        {3600, 1800, 0.556, 2, 2, 4},
+    };
+
+private:
+    void init_speed();
+    void init_prereq();
+    void init_timing();
+    void init_bank_timing(vector<TimingEntry>* t, const SpeedEntry& s);
+};
+
+} /*namespace ramulator*/
+
+#endif /*__HBM2_H*/
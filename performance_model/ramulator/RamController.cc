@@ -7,10 +7,14 @@ namespace ramulator
 
 	RamController::RamController(const RamConfig& configs, RamDRAM* channel) :
         channel(channel),
-        scheduler(new RamScheduler(this)),
-        rowpolicy(new RowPolicy(this)),
+        scheduler(RamScheduler::create(this, RamScheduler::parse(configs["scheduler"]))),
+        rowpolicy(RowPolicy::create(this, RowPolicy::parse(configs["row_policy"]))),
         rowtable(new RowTable(this)),
         refresh(new Refresh(this)),
+        // every bank may be due for refresh at once
+        otherq(max(32, int(channel->children.size()) * channel->spec->banks_per_rank())),
+        write_addrs(writeq.max),
+        pending(64),
         cmd_trace_files(channel->children.size())
     {
         record_cmd_trace = configs.record_cmd_trace();
@@ -82,50 +86,50 @@ namespace ramulator
             ;
 		/* Bank Stats*/
 		bank_reads
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("read_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of reads for read requests per bank per channel per core")
 			.precision(0)
 			;
 		bank_writes
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("write_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of writes for read requests per bank per channel per core")
 			.precision(0)
 			;
 		bank_read_row_hits
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("read_row_hits_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of row hits for read requests per bank per channel per core")
 			.precision(0)
 			;
 		bank_read_row_misses
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("read_row_misses_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of row misses for read requests per bank per channel per core")
 			.precision(0)
 			;
 		bank_read_row_conflicts
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("read_row_conflicts_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of row conflicts for read requests per bank per channel per core")
 			.precision(0)
 			;
 
 		bank_write_row_hits
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("write_row_hits_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of row hits for write requests per bank per channel per core")
 			.precision(0)
 			;
 		bank_write_row_misses
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("write_row_misses_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of row misses for write requests per bank per channel per core")
 			.precision(0)
 			;
 		bank_write_row_conflicts
-			.init(configs.get_ranks() * 2)
+			.init(configs.get_ranks() * channel->spec->banks_per_rank())
 			.name("write_row_conflicts_channel_" + to_string(channel->id) + "_core")
 			.desc("Number of row conflicts for write requests per bank per channel per core")
 			.precision(0)
@@ -202,6 +206,7 @@ namespace ramulator
     void RamController::tick()
     {
         clk++;
+        cached_event = -1;
         req_queue_length_sum += readq.size() + writeq.size() + pending.size();
         read_req_queue_length_sum += readq.size() + pending.size();
         write_req_queue_length_sum += writeq.size();
@@ -215,7 +220,7 @@ namespace ramulator
                   channel->update_serving_requests(
                       req.addr_vec.data(), -1, clk);
                 }
-                req.callback(req);
+                complete(req);
                 pending.pop_front();
             }
         }
@@ -224,16 +229,7 @@ namespace ramulator
         refresh->tick_ref();
 
         /*** 3. Should we schedule writes? ***/
-        if (!write_mode) {
-            // yes -- write queue is almost full or read queue is empty
-            if (writeq.size() >= int(0.8 * writeq.max) || readq.size() == 0)
-                write_mode = true;
-        }
-        else {
-            // no -- write queue is almost empty and read queue is not empty
-            if (writeq.size() <= int(0.2 * writeq.max) && readq.size() != 0)
-                write_mode = false;
-        }
+        update_write_mode();
 
         /*** 4. Find the best command to schedule, if any ***/
         Queue* queue = !write_mode ? &readq : &writeq;
@@ -241,17 +237,17 @@ namespace ramulator
             queue = &otherq;  // "other" requests are rare, so we give them precedence over reads/writes
 
         auto req = scheduler->get_head(queue->q);
-        if (req == queue->q.end() || !is_ready(req)) {
+        if (req == queue->q.end() || !scheduler->is_ready(req)) {
             // we couldn't find a command to schedule -- let's try to be speculative
             auto cmd = Command::PRE;
             vector<int> victim = rowpolicy->get_victim(cmd);
             if (!victim.empty()){
-                issue_cmd(cmd, victim);
+                issue_cmd(cmd, victim.data());
             }
             return;  // nothing more to be done this cycle
         }
 		// ZMAC_ADDED: bank stats
-		int bank_i = req->addr_vec[int(Level::Rank)] * 2 + req->addr_vec[int(Level::Bank)];
+		int bank_i = channel->spec->bank_index(req->addr_vec.data());
 		if (req->type == RamRequest::Type::READ) {
 			// ZMAC_ADDED: bank stats
 			++bank_reads[bank_i];
@@ -303,7 +299,7 @@ namespace ramulator
         }
 
         // issue command on behalf of request
-        auto cmd = get_first_cmd(req);
+        auto cmd = scheduler->first_cmd(req);
         issue_cmd(cmd, get_addr_vec(cmd, req));
 
         // check whether this is the last command (which finishes the request)
@@ -317,35 +313,99 @@ namespace ramulator
         }
 
         if (req->type == RamRequest::Type::WRITE) {
+            write_addrs.erase(req->addr);
             channel->update_serving_requests(req->addr_vec.data(), -1, clk);
+            // writes complete once the data burst is written
+            req->depart = clk + channel->spec->speed_entry.nCWL + channel->spec->speed_entry.nBL;
+            complete(*req);
         }
 
         // remove request from queue
         queue->q.erase(req);
     }
 
+    long RamController::next_event()
+    {
+        if (cached_event > clk)
+            return cached_event;
+
+        long event = refresh->next_refresh();
+
+        if (pending.size())
+            event = min(event, pending[0].depart);
+
+        // a queued request can be scheduled once its first command is ready
+        Queue* queues[] = {&readq, &writeq, &otherq};
+        for (auto queue : queues) {
+            for (auto req = queue->q.begin(); req != queue->q.end(); req++) {
+                event = min(event, channel->get_next(get_first_cmd(req), req->addr_vec.data()));
+            }
+        }
+
+        // speculative precharge of the open rows
+        if (rowpolicy->type != RowPolicy::Type::Opened) {
+            for (auto& kv : rowtable->table) {
+                long ready = channel->get_next(Command::PRE, kv.first.data());
+                if (rowpolicy->type == RowPolicy::Type::Timeout)
+                    ready = max(ready, kv.second.timestamp + rowpolicy->timeout);
+                event = min(event, ready);
+            }
+        }
+
+        cached_event = max(event, clk + 1);
+        return cached_event;
+    }
+
+    void RamController::skip(long cycles)
+    {
+        clk += cycles;
+        req_queue_length_sum += (readq.size() + writeq.size() + pending.size()) * cycles;
+        read_req_queue_length_sum += (readq.size() + pending.size()) * cycles;
+        write_req_queue_length_sum += writeq.size() * cycles;
+
+        refresh->clk += cycles;
+        update_write_mode();
+    }
+
+	void RamController::run_to(long target, vector<long>& ticks, vector<char>& active)
+	{
+		while (clk < target) {
+			long event = next_event();
+			if (event > target) {
+				skip(target - clk);
+				return;
+			}
+			if (event - clk > 1)
+				skip(event - clk - 1);
+			tick();
+			ticks.push_back(clk);
+			active.push_back(is_active());
+		}
+	}
+
 	void RamController::setBankRef(int bank_i, bool hot)
 	{
 		refresh->set_ref_interval(bank_i, hot);
+		cached_event = -1;
 	}
 
-    void RamController::issue_cmd(Command cmd, const vector<int>& addr_vec)
+    void RamController::issue_cmd(Command cmd, const int* addr_vec)
     {
         assert(is_ready(cmd, addr_vec));
-        channel->update(cmd, addr_vec.data(), clk);
+        channel->update(cmd, addr_vec, clk);
         rowtable->update(cmd, addr_vec, clk);
+        if (channel->spec->is_accessing(cmd))
+            last_cas_group = channel->spec->group_index(addr_vec);
         if (record_cmd_trace){
             // select rank
-            auto& file = cmd_trace_files[addr_vec[1]];
+            auto& file = cmd_trace_files[addr_vec[int(Level::Rank)]];
             string& cmd_name = channel->spec->command_name[int(cmd)];
             file<<clk<<','<<cmd_name;
             // TODO bad coding here
             if (cmd_name == "PREA" || cmd_name == "REF")
                 file<<endl;
             else{
-                int bank_id = addr_vec[int(Level::Bank)];
-                if (channel->spec->standard_name == "DDR4" || channel->spec->standard_name == "GDDR5")
-                    bank_id += addr_vec[int(Level::Bank) - 1] * channel->spec->org_entry.count[int(Level::Bank)];
+                int bank_id = channel->spec->bank_index(addr_vec) % channel->spec->banks_per_rank();
                 file<<','<<bank_id<<endl;
             }
         }
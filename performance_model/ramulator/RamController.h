@@ -11,18 +11,19 @@
 
 #include "RamConfig.h"
 #include "RamDRAM.h"
+#include "RamQueue.h"
 #include "RamRefresh.h"
 #include "RamRequest.h"
 #include "RamScheduler.h"
 #include "RamStatistics.h"
 
-#include "HBM.h"
+#include "RamSpec.h"
 
 using namespace std;
 
 namespace ramulator
 {
-class HBM;
+class RamSpec;
 class RamScheduler;
 class RowTable;
 class RowPolicy;
@@ -72,18 +73,27 @@ public:
     RowTable* rowtable;  // tracks metadata about rows (e.g., which are open and for how long)
     Refresh* refresh;
 
+    typedef RingBuffer<RamRequest>::iterator ReqIter;
+
     struct Queue {
-        list<RamRequest> q;
-        unsigned int max = 32;
+        RingBuffer<RamRequest> q;
+        unsigned int max;
+        Queue(unsigned int max = 32) : q(max), max(max) {}
         unsigned int size() {return q.size();}
     };
 
     Queue readq;  // queue for read requests
     Queue writeq;  // queue for write requests
     Queue otherq;  // queue for all "other" requests (e.g., refresh)
+    AddrTable write_addrs;  // addresses in writeq, for read forwarding
 
-    deque<RamRequest> pending;  // read requests that are about to receive data from DRAM
+    RingBuffer<RamRequest> pending;  // read requests that are about to receive data from DRAM
     bool write_mode = false;  // whether write requests should be prioritized over reads
+    int last_cas_group = -1;  // bank group (RamSpec::group_index) of the last RD/WR
+    long cached_event = -1;  // next_event(), -1 if it must be recomputed
+    // If set, completion callbacks are not called but queued with their clock,
+    // so that RamMemory can replay them in serial order after a parallel run
+    vector<pair<long, RamRequest>>* deferred = NULL;
     //long refreshed = 0;  // last time refresh requests were generated
 
     /* Command trace for DRAMPower 3.1 */
@@ -124,64 +134,94 @@ public:
             return false;
 
         req.arrive = clk;
-        queue.q.push_back(req);
+        cached_event = -1;
         // shortcut for read requests, if a write to same addr exists
         // necessary for coherence
-        if (req.type == RamRequest::Type::READ && find_if(writeq.q.begin(), writeq.q.end(),
-                [req](RamRequest& wreq){ return req.addr == wreq.addr;}) != writeq.q.end()){
+        if (req.type == RamRequest::Type::READ && write_addrs.contains(req.addr)) {
             req.depart = clk + 1;
             pending.push_back(req);
-            readq.q.pop_back();
+            return true;
         }
+        queue.q.push_back(req);
+        if (req.type == RamRequest::Type::WRITE)
+            write_addrs.insert(req.addr);
         return true;
     }
 
 	// Move to .cc because of forward declaration
 	void tick();
 
+	// Earliest clock (> clk) at which tick() may issue a command, serve a read
+	// or inject a refresh; every tick before it only updates statistics
+	// Cached until the controller ticks or receives a request
+	long next_event();
+
+	// Advance the clock by 'cycles' idle ticks, all of them before next_event()
+	void skip(long cycles);
+
+	// Simulate this controller alone up to cycle 'target', as RamMemory::fast_forward
+	// would do it; the clock of every tick and is_active() after it are appended
+	// to 'ticks' and 'active'
+	void run_to(long target, vector<long>& ticks, vector<char>& active);
+
 	// ZMAC ADDED: Set refresh rate for banks
 	void setBankRef(int bank_i, bool hot);
 
-    bool is_ready(list<RamRequest>::iterator req)
+    void complete(RamRequest& req)
+    {
+        if (deferred)
+            deferred->push_back(make_pair(clk, req));
+        else
+            req.callback(req);
+    }
+
+    bool is_ready(ReqIter req)
     {
         Command cmd = get_first_cmd(req);
         return channel->check(cmd, req->addr_vec.data(), clk);
     }
 
-    bool is_ready(Command cmd, const vector<int>& addr_vec)
+    bool is_ready(Command cmd, const int* addr_vec)
     {
-        return channel->check(cmd, addr_vec.data(), clk);
+        return channel->check(cmd, addr_vec, clk);
     }
 
-    bool is_row_hit(list<RamRequest>::iterator req)
+    bool is_row_hit(ReqIter req)
     {
         // cmd must be decided by the request type, not the first cmd
         Command cmd = channel->spec->translate[int(req->type)];
         return channel->check_row_hit(cmd, req->addr_vec.data());
     }
 
-    bool is_row_hit(Command cmd, const vector<int>& addr_vec)
+    bool is_row_hit(Command cmd, const int* addr_vec)
     {
-        return channel->check_row_hit(cmd, addr_vec.data());
+        return channel->check_row_hit(cmd, addr_vec);
     }
 
-    bool is_row_open(list<RamRequest>::iterator req)
+    bool is_row_open(ReqIter req)
     {
         // cmd must be decided by the request type, not the first cmd
         Command cmd = channel->spec->translate[int(req->type)];
         return channel->check_row_open(cmd, req->addr_vec.data());
     }
 
-    bool is_row_open(Command cmd, const vector<int>& addr_vec)
+    bool is_row_open(Command cmd, const int* addr_vec)
     {
-        return channel->check_row_open(cmd, addr_vec.data());
+        return channel->check_row_open(cmd, addr_vec);
     }
 
-	/*
-    void update_temp(ALDRAM::Temp current_temperature)
+    // ALDRAM: timing of a bank (counted as in bank stats) for its temperature
+    void update_temp(int bank_i, RamSpec::Temp temp)
     {
+        int addr_vec[int(Level::MAX)];
+        int banks = channel->spec->banks_per_rank();
+        channel->spec->split_bank(bank_i % banks, addr_vec);
+        RamDRAM* node = channel->children[bank_i / banks];
+        for (int lev = int(Level::PseudoChannel); lev <= int(Level::Bank); lev++)
+            node = node->children[addr_vec[lev]];
+        node->set_timing(channel->spec->temp_timing[int(temp)]);
+        cached_event = -1;
     }
-	*/
 
     // For telling whether this channel is busying in processing read or write
     bool is_active() {
@@ -198,17 +238,31 @@ public:
     }
 
 private:
-    Command get_first_cmd(list<RamRequest>::iterator req)
+    void update_write_mode()
+    {
+        if (!write_mode) {
+            // yes -- write queue is almost full or read queue is empty
+            if (writeq.size() >= int(0.8 * writeq.max) || readq.size() == 0)
+                write_mode = true;
+        }
+        else {
+            // no -- write queue is almost empty and read queue is not empty
+            if (writeq.size() <= int(0.2 * writeq.max) && readq.size() != 0)
+                write_mode = false;
+        }
+    }
+
+    Command get_first_cmd(ReqIter req)
     {
         Command cmd = channel->spec->translate[int(req->type)];
         return channel->decode(cmd, req->addr_vec.data());
     }
 
 	// Move to .cc because of forward decalaration
-	void issue_cmd(Command cmd, const vector<int>& addr_vec);
+	void issue_cmd(Command cmd, const int* addr_vec);
 
-    vector<int> get_addr_vec(Command cmd, list<RamRequest>::iterator req){
-        return req->addr_vec;
+    const int* get_addr_vec(Command cmd, ReqIter req){
+        return req->addr_vec.data();
     }
 };
 
@@ -220,8 +274,6 @@ vector<int> Controller<SALP>::get_addr_vec(
 template <>
 bool Controller<SALP>::is_ready(list<Request>::iterator req);
 
-template <>
-void Controller<ALDRAM>::update_temp(ALDRAM::Temp current_temperature);
 
 template <>
 void Controller<TLDRAM>::tick();
@@ -73,7 +73,7 @@ void RamDRAM::finish(long dram_cycles) {
 }
 
 // Constructor
-RamDRAM::RamDRAM(HBM* spec, Level level) :
+RamDRAM::RamDRAM(RamSpec* spec, Level level) :
     spec(spec), level(level), id(0), parent(NULL)
 {
 
@@ -85,14 +85,18 @@ RamDRAM::RamDRAM(HBM* spec, Level level) :
     timing = spec->timing[int(level)];
 
     fill_n(next, int(Command::MAX), -1); // initialize future
+    int total = 0;
     for (int cmd = 0; cmd < int(Command::MAX); cmd++) {
         int dist = 0;
         for (auto& t : timing[cmd])
             dist = max(dist, t.dist);
 
-        if (dist)
-            prev[cmd].resize(dist, -1); // initialize history
+        prev_base[cmd] = total;
+        prev_len[cmd] = dist;
+        prev_head[cmd] = 0;
+        total += dist;
     }
+    history.assign(total, -1); // initialize history
 
     // try to recursively construct my children
     int child_level = int(level) + 1;
@@ -250,16 +254,14 @@ void RamDRAM::update_timing(Command cmd, const int* addr, long clk)
     }
 
     // I am a target node
-    if (prev[int(cmd)].size()) {
-        prev[int(cmd)].pop_back();  // FIXME TIANSHI why pop back?
-        prev[int(cmd)].push_front(clk); // update history
-    }
+    if (prev_len[int(cmd)])
+        push_prev(int(cmd), clk); // update history
 
     for (auto& t : timing[int(cmd)]) {
         if (t.sibling)
             continue; // not an applicable timing parameter
 
-        long past = prev[int(cmd)][t.dist-1];
+        long past = get_prev(int(cmd), t.dist);
         if (past < 0)
             continue; // not enough history
 
@@ -11,19 +11,13 @@
 #include <cassert>
 #include <type_traits>
 
-#include "HBM.h"
+#include "RamSpec.h"
 
 using namespace std;
 
 namespace ramulator
 {
-class HBM;
-enum class Level;
-enum class Command;
-enum class State;
-struct TimingEntry;
-enum class Org;
-enum class Speed;
+class RamSpec;
 
 class RamDRAM
 {
@@ -40,11 +34,11 @@ public:
 	ScalarStat serving_writes;
 
     // Constructor
-    RamDRAM(HBM* spec, Level level);
+    RamDRAM(RamSpec* spec, Level level);
     ~RamDRAM();
 
     // Specification (e.g., DDR3)
-    HBM* spec;
+    RamSpec* spec;
 
     // Tree Organization (e.g., Channel->Rank->Bank->Row->Column)
     Level level;
@@ -58,8 +52,9 @@ public:
 
     // State of Rows:
     // There are too many rows for them to be instantiated individually
-    // Instead, their bank (or an equivalent entity) tracks their state for them
-    map<int, State> row_state;
+    // Instead, their bank (or an equivalent entity) tracks their state for them.
+    // A bank holds at most one open row, so a single slot is enough (-1 if none)
+    int open_row = -1;
 
     // Insert a node as one of my child nodes
     void insert(RamDRAM* child);
@@ -81,6 +76,10 @@ public:
 
     // Update the timing/state of the tree, signifying that a command has been issued
     void update(Command cmd, const int* addr, long clk);
+
+    // Use another timing table of this level for the commands issued from now on
+    // (e.g., RamSpec::temp_timing for a bank)
+    void set_timing(vector<TimingEntry>* table) { timing = table; }
     // Update statistics:
 
     // Update the number of requests it serves currently
@@ -106,10 +105,32 @@ private:
 
     // Timing
     long cur_clk = 0;
-    //long next[int(Command::MAX)]; // the earliest time in the future when a command could be ready
-    //deque<long> prev[int(Command::MAX)]; // the most recent history of when commands were issued
-    long next[13]; // the earliest time in the future when a command could be ready
-    deque<long> prev[13]; // the most recent history of when commands were issued
+    long next[int(Command::MAX)]; // the earliest time in the future when a command could be ready
+
+    // The most recent history of when commands were issued:
+    // one circular window per command, as long as the largest dist of its timing entries,
+    // all windows of a node share a single allocation made by the constructor
+    vector<long> history;
+    int prev_base[int(Command::MAX)]; // offset of the window in history
+    int prev_len[int(Command::MAX)]; // length of the window (0 if the command has no history)
+    int prev_head[int(Command::MAX)]; // slot of the most recent entry
+
+    // Record that a command was issued at clk, dropping its oldest entry
+    void push_prev(int cmd, long clk)
+    {
+        int head = prev_head[cmd] == 0 ? prev_len[cmd] - 1 : prev_head[cmd] - 1;
+        prev_head[cmd] = head;
+        history[prev_base[cmd] + head] = clk;
+    }
+
+    // When a command was issued dist times ago (dist = 1 is the most recent), -1 if never
+    long get_prev(int cmd, int dist) const
+    {
+        int slot = prev_head[cmd] + dist - 1;
+        if (slot >= prev_len[cmd])
+            slot -= prev_len[cmd];
+        return history[prev_base[cmd] + slot];
+    }
 
     // Lookup table for which commands must be preceded by which other commands (i.e., "prerequisite")
     // E.g., a read command to a closed bank must be preceded by an activate command
@@ -6,21 +6,24 @@
 #include "RamRequest.h"
 #include "RamController.h"
 #include "RamStatistics.h"
+#include "RamWorkers.h"
 
-#include "HBM.h"
+#include "RamSpec.h"
 
 #include <vector>
 #include <functional>
+#include <climits>
 #include <cmath>
 #include <cassert>
 #include <tuple>
+#include <algorithm>
 
 using namespace std;
 
 namespace ramulator
 {
 
-class HBM;
+class RamSpec;
 
 class MemoryBase{
 public:
@@ -80,7 +83,27 @@ public:
     map<pair<int, long>, long> page_translation;
 
     vector<RamController*> ctrls;
-    HBM * spec;
+    vector<long> next_events;  // scratch for advance()
+
+    // Parallel fast-forward ("threads" and "quantum" configs)
+    // The controllers are split into 'threads' groups of neighbours, each group
+    // is simulated by one worker up to the end of a quantum of DRAM cycles
+    // Shorter fast-forwards ("parallel_threshold") stay serial, waking the
+    // workers would cost more than simulating them
+    RamWorkers* workers = NULL;
+    long quantum = 50000;
+    long parallel_threshold = 4096;
+    struct CtrlTrace {
+        vector<long> ticks;  // clocks at which the controller ticked
+        vector<char> active;  // is_active() after each of these ticks
+        vector<pair<long, RamRequest>> deferred;  // callbacks to replay
+        bool was_active;
+        double queue_sum, read_queue_sum, write_queue_sum;
+    };
+    vector<CtrlTrace> traces;
+    vector<tuple<long, int, int>> trace_points;  // (clock, controller, tick)
+    vector<pair<tuple<long, int, int>, RamRequest*>> trace_callbacks;
+    RamSpec * spec;
     vector<int> addr_bits;
 
     int tx_bits;
@@ -113,6 +136,20 @@ public:
 
         addr_bits[int(Level::MAX) - 1] -= calc_log2(spec->prefetch_size);
 
+        // Parallel fast-forward, not with a command trace on stdout whose
+        // lines would interleave
+        int threads = configs.contains("threads") ? stoi(configs["threads"]) : 1;
+        threads = min(threads, int(ctrls.size()));
+        if (configs.contains("quantum"))
+            quantum = stol(configs["quantum"]);
+        assert(quantum > 0);
+        if (configs.contains("parallel_threshold"))
+            parallel_threshold = stol(configs["parallel_threshold"]);
+        if (threads > 1 && !ctrls[0]->print_cmd_trace) {
+            workers = new RamWorkers(threads);
+            traces.resize(ctrls.size());
+        }
+
         // Initiating translation
         if (configs.contains("translation")) {
           translation = name_to_translation[configs["translation"]];
@@ -217,6 +254,7 @@ public:
 
     ~RamMemory()
     {
+        delete workers;
         for (auto ctrl: ctrls)
             delete ctrl;
         delete spec;
@@ -235,27 +273,156 @@ public:
 
     void tick()
     {
-        ++num_dram_cycles;
-        int cur_que_req_num = 0;
-        int cur_que_readreq_num = 0;
-        int cur_que_writereq_num = 0;
-        for (auto ctrl : ctrls) {
-          cur_que_req_num += ctrl->readq.size() + ctrl->writeq.size() + ctrl->pending.size();
-          cur_que_readreq_num += ctrl->readq.size() + ctrl->pending.size();
-          cur_que_writereq_num += ctrl->writeq.size();
+        account(1);
+        for (auto ctrl : ctrls)
+          ctrl->tick();
+    }
+
+    // Simulate 'cycles' ticks, jumping over the idle stretches between events
+    // Returns the number of event cycles which were really simulated
+    long fast_forward(long cycles)
+    {
+        if (workers && cycles >= parallel_threshold)
+            return parallel_fast_forward(cycles);
+
+        long events = 0;
+        while (cycles > 0) {
+            cycles -= advance(cycles);
+            events++;
         }
-        in_queue_req_num_sum += cur_que_req_num;
-        in_queue_read_req_num_sum += cur_que_readreq_num;
-        in_queue_write_req_num_sum += cur_que_writereq_num;
+        return events;
+    }
 
-        bool is_active = false;
-        for (auto ctrl : ctrls) {
-          is_active = is_active || ctrl->is_active();
-          ctrl->tick();
+    // fast_forward() on the worker pool
+    // No request enters the controllers while fast-forwarding, so they share
+    // no state: each one runs its own event loop to the end of the quantum.
+    // The global statistics, the number of event cycles and the callbacks are
+    // then merged in the order of the serial loop, the results are identical.
+    // Callbacks must not send requests, since they run after the quantum.
+    long parallel_fast_forward(long cycles)
+    {
+        if (cycles <= 0)
+            return 0;
+
+        long events = 0;
+        bool ends_on_event = false;
+        while (cycles > 0) {
+            long start = ctrls[0]->clk;
+            long target = start + min(cycles, quantum);
+            for (unsigned int i = 0; i < ctrls.size(); i++) {
+                CtrlTrace& trace = traces[i];
+                trace.ticks.clear();
+                trace.active.clear();
+                trace.deferred.clear();
+                trace.was_active = ctrls[i]->is_active();
+                trace.queue_sum = ctrls[i]->req_queue_length_sum.value();
+                trace.read_queue_sum = ctrls[i]->read_req_queue_length_sum.value();
+                trace.write_queue_sum = ctrls[i]->write_req_queue_length_sum.value();
+                ctrls[i]->deferred = &trace.deferred;
+            }
+
+            int groups = workers->size();
+            workers->run([this, groups, target](int g) {
+                unsigned int begin = ctrls.size() * g / groups;
+                unsigned int end = ctrls.size() * (g + 1) / groups;
+                for (unsigned int i = begin; i < end; i++)
+                    ctrls[i]->run_to(target, traces[i].ticks, traces[i].active);
+            });
+
+            // Statistics of account(): the queue occupancy is the sum of the
+            // controllers' own, a cycle is active if any controller is active
+            num_dram_cycles += target - start;
+            vector<tuple<long, int, int>>& points = trace_points;
+            vector<pair<tuple<long, int, int>, RamRequest*>>& callbacks = trace_callbacks;
+            points.clear();
+            callbacks.clear();
+            int n_active = 0;
+            for (unsigned int i = 0; i < ctrls.size(); i++) {
+                CtrlTrace& trace = traces[i];
+                ctrls[i]->deferred = NULL;
+                in_queue_req_num_sum += ctrls[i]->req_queue_length_sum.value() - trace.queue_sum;
+                in_queue_read_req_num_sum += ctrls[i]->read_req_queue_length_sum.value() - trace.read_queue_sum;
+                in_queue_write_req_num_sum += ctrls[i]->write_req_queue_length_sum.value() - trace.write_queue_sum;
+                n_active += trace.was_active;
+                for (unsigned int k = 0; k < trace.ticks.size(); k++)
+                    points.push_back(make_tuple(trace.ticks[k], int(i), int(k)));
+                for (unsigned int k = 0; k < trace.deferred.size(); k++)
+                    callbacks.push_back(make_pair(make_tuple(trace.deferred[k].first, int(i), int(k)), &trace.deferred[k].second));
+            }
+            sort(points.begin(), points.end());
+
+            long prev = start;
+            for (unsigned int p = 0; p < points.size(); p++) {
+                long clk = get<0>(points[p]);
+                if (clk != prev) {
+                    if (n_active)
+                        ramulator_active_cycles += clk - prev;
+                    prev = clk;
+                    events++;
+                }
+                CtrlTrace& trace = traces[get<1>(points[p])];
+                int k = get<2>(points[p]);
+                bool before = k ? trace.active[k - 1] : trace.was_active;
+                n_active += int(trace.active[k]) - int(before);
+            }
+            if (n_active && target > prev)
+                ramulator_active_cycles += target - prev;
+            ends_on_event = (prev == target && points.size());
+
+            // Completions in the order the serial loop ticks the controllers
+            sort(callbacks.begin(), callbacks.end(),
+                 [](const pair<tuple<long, int, int>, RamRequest*>& a,
+                    const pair<tuple<long, int, int>, RamRequest*>& b) { return a.first < b.first; });
+            for (auto& cb : callbacks)
+                cb.second->callback(*cb.second);
+
+            cycles -= target - start;
         }
-        if (is_active) {
-          ramulator_active_cycles++;
+        // the serial loop also counts its last advance if no event ends it
+        if (!ends_on_event)
+            events++;
+        return events;
+    }
+
+    // Jump to the next event of any controller and simulate it
+    void step()
+    {
+        advance(LONG_MAX);
+    }
+
+    // Advance to the next event of any controller, at most 'cycles' cycles
+    // Only the controllers with an event at that cycle are ticked, the
+    // others (and every controller before it) only account the idle cycles
+    // Returns the number of cycles advanced
+    long advance(long cycles)
+    {
+        long clk = ctrls[0]->clk;
+        long event = (cycles == LONG_MAX) ? LONG_MAX : clk + cycles;
+        next_events.resize(ctrls.size());
+        for (unsigned int i = 0; i < ctrls.size(); i++) {
+            next_events[i] = ctrls[i]->next_event();
+            event = min(event, next_events[i]);
+        }
+
+        if (event - clk > 1)
+            skip(event - clk - 1);
+
+        account(1);
+        for (unsigned int i = 0; i < ctrls.size(); i++) {
+            if (next_events[i] == event)
+                ctrls[i]->tick();
+            else
+                ctrls[i]->skip(1);
         }
+        return event - clk;
+    }
+
+    // Idle ticks: no command, refresh or read completion in any controller
+    void skip(long cycles)
+    {
+        account(cycles);
+        for (auto ctrl : ctrls)
+          ctrl->skip(cycles);
     }
 
     bool send(RamRequest req)
@@ -323,6 +490,28 @@ public:
       in_queue_write_req_num_avg = in_queue_write_req_num_sum.value() / dram_cycles;
     }
 
+    // Statistics of 'cycles' cycles with the current queue occupancy
+    void account(long cycles)
+    {
+        num_dram_cycles += cycles;
+        int cur_que_req_num = 0;
+        int cur_que_readreq_num = 0;
+        int cur_que_writereq_num = 0;
+        bool is_active = false;
+        for (auto ctrl : ctrls) {
+          cur_que_req_num += ctrl->readq.size() + ctrl->writeq.size() + ctrl->pending.size();
+          cur_que_readreq_num += ctrl->readq.size() + ctrl->pending.size();
+          cur_que_writereq_num += ctrl->writeq.size();
+          is_active = is_active || ctrl->is_active();
+        }
+        in_queue_req_num_sum += double(cur_que_req_num) * cycles;
+        in_queue_read_req_num_sum += double(cur_que_readreq_num) * cycles;
+        in_queue_write_req_num_sum += double(cur_que_writereq_num) * cycles;
+        if (is_active) {
+          ramulator_active_cycles += cycles;
+        }
+    }
+
     long page_allocator(long addr, int coreid) {
         long virtual_page_number = addr >> 12;
 
@@ -0,0 +1,220 @@
+#ifndef __RAM_QUEUE_H
+#define __RAM_QUEUE_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace ramulator
+{
+
+/*
+ * Ring buffer of requests
+ *   The storage is allocated once (power-of-two capacity) and only grows if
+ *   a push finds it full, which the bounded controller queues never do.
+ *   Entries stay in arrival order; erase() closes the gap by shifting the
+ *   younger entries, which is cheap for the short controller queues.
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        iterator() : buf(NULL), idx(0) {}
+        iterator(RingBuffer* buf, unsigned int idx) : buf(buf), idx(idx) {}
+
+        T& operator*() const { return (*buf)[idx]; }
+        T* operator->() const { return &(*buf)[idx]; }
+        iterator& operator++() { idx++; return *this; }
+        iterator operator++(int) { iterator tmp = *this; idx++; return tmp; }
+        bool operator==(const iterator& other) const { return idx == other.idx && buf == other.buf; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+        unsigned int index() const { return idx; }
+
+    private:
+        RingBuffer* buf;
+        unsigned int idx;  // position from the head
+    };
+
+    RingBuffer(unsigned int capacity = 32)
+        : head(0), count(0)
+    {
+        cap = 1;
+        while (cap < capacity)
+            cap <<= 1;
+        data = new T[cap];
+    }
+
+    ~RingBuffer()
+    {
+        delete [] data;
+    }
+
+    unsigned int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](unsigned int i) { return data[(head + i) & (cap - 1)]; }
+    const T& operator[](unsigned int i) const { return data[(head + i) & (cap - 1)]; }
+    T& front() { return (*this)[0]; }
+    T& back() { return (*this)[count - 1]; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, count); }
+
+    void push_back(const T& v)
+    {
+        if (count == cap)
+            grow();
+        (*this)[count] = v;
+        count++;
+    }
+
+    void pop_back()
+    {
+        assert(count > 0);
+        count--;
+    }
+
+    void pop_front()
+    {
+        assert(count > 0);
+        head = (head + 1) & (cap - 1);
+        count--;
+    }
+
+    void erase(iterator it)
+    {
+        unsigned int i = it.index();
+        assert(i < count);
+        for (; i + 1 < count; i++)
+            (*this)[i] = std::move((*this)[i + 1]);
+        count--;
+    }
+
+private:
+    T* data;
+    unsigned int cap;  // power of two
+    unsigned int head;
+    unsigned int count;
+
+    RingBuffer(const RingBuffer&);
+    RingBuffer& operator=(const RingBuffer&);
+
+    void grow()
+    {
+        T* bigger = new T[cap * 2];
+        for (unsigned int i = 0; i < count; i++)
+            bigger[i] = std::move((*this)[i]);
+        delete [] data;
+        data = bigger;
+        head = 0;
+        cap *= 2;
+    }
+};
+
+/*
+ * Multiset of addresses with a fixed number of slots
+ *   Open addressing with linear probing and backward-shift deletion.
+ *   Used to find a write to the same address for read forwarding,
+ *   holds at most half as many distinct addresses as it has slots.
+ */
+class AddrTable
+{
+public:
+    AddrTable(unsigned int max_entries)
+        : n_entries(0)
+    {
+        n_slots = 1;
+        while (n_slots < 2 * max_entries)
+            n_slots <<= 1;
+        addrs = new long[n_slots];
+        counts = new unsigned int[n_slots];
+        for (unsigned int i = 0; i < n_slots; i++)
+            counts[i] = 0;
+    }
+
+    ~AddrTable()
+    {
+        delete [] addrs;
+        delete [] counts;
+    }
+
+    bool contains(long addr) const
+    {
+        return counts[find(addr)] != 0;
+    }
+
+    void insert(long addr)
+    {
+        unsigned int i = find(addr);
+        if (counts[i] == 0) {
+            assert(2 * (n_entries + 1) <= n_slots);
+            addrs[i] = addr;
+            n_entries++;
+        }
+        counts[i]++;
+    }
+
+    void erase(long addr)
+    {
+        unsigned int i = find(addr);
+        assert(counts[i] != 0);
+        if (--counts[i] != 0)
+            return;
+        n_entries--;
+
+        // shift back the entries of the probe chain which follows the hole
+        unsigned int j = i;
+        while (true) {
+            j = (j + 1) & (n_slots - 1);
+            if (counts[j] == 0)
+                break;
+            unsigned int home = hash(addrs[j]);
+            // the entry can move to the hole if its home is not in (i, j]
+            if (((j - home) & (n_slots - 1)) >= ((j - i) & (n_slots - 1))) {
+                addrs[i] = addrs[j];
+                counts[i] = counts[j];
+                counts[j] = 0;
+                i = j;
+            }
+        }
+    }
+
+private:
+    long* addrs;
+    unsigned int* counts;  // 0 if the slot is free
+    unsigned int n_slots;  // power of two
+    unsigned int n_entries;
+
+    AddrTable(const AddrTable&);
+    AddrTable& operator=(const AddrTable&);
+
+    unsigned int hash(long addr) const
+    {
+        unsigned long h = (unsigned long)addr * 0x9E3779B97F4A7C15UL;
+        return (unsigned int)(h >> 32) & (n_slots - 1);
+    }
+
+    // Slot holding 'addr', or the free slot ending its probe chain
+    unsigned int find(long addr) const
+    {
+        unsigned int i = hash(addr);
+        while (counts[i] != 0 && addrs[i] != addr)
+            i = (i + 1) & (n_slots - 1);
+        return i;
+    }
+};
+
+} /*namespace ramulator*/
+
+#endif /*__RAM_QUEUE_H*/
@@ -8,6 +8,7 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>
 
 #include "RamRefresh.h"
 #include "RamController.h"
@@ -21,14 +22,15 @@ namespace ramulator {
 	Refresh::Refresh(RamController* ctrl) : ctrl(ctrl) {
     clk = refreshed = 0;
     max_rank_count = ctrl->channel->children.size();
-    max_bank_count = ctrl->channel->spec->org_entry.count[(int)Level::Bank];
+    max_bank_count = ctrl->channel->spec->banks_per_rank();
 	n_banks = max_rank_count * max_bank_count;
 	
-	bank_ref_interval = new long[n_banks];
-	bank_refreshed = new long[n_banks];
+	bank_ref_interval.assign(n_banks, ctrl->channel->spec->speed_entry.nREFI);
+	bank_refreshed.assign(n_banks, 0);
+	// all deadlines are equal, so the identity order is already a heap
 	for (int i = 0; i < n_banks; i++) {
-		bank_ref_interval[i] = ctrl->channel->spec->speed_entry.nREFI;
-		bank_refreshed[i] = 0;
+		deadline_heap.push_back(i);
+		heap_pos.push_back(i);
 	}
 
     // Init refresh counters
@@ -45,21 +47,23 @@ namespace ramulator {
   // Basic refresh scheduling for all bank refresh that is applicable to all DRAM types
   void Refresh::tick_ref() {
     clk++;
-	for (int i = 0; i < n_banks; i++) {
-		if ((clk - bank_refreshed[i]) >= bank_ref_interval[i]) {
-			inject_bank_refresh(i);
+	if (deadline(deadline_heap[0]) <= clk) {
+		// Collect every bank which is due; a shortened interval may make several
+		// due at once, they are injected in bank order like a full scan would do
+		vector<int> due;
+		while (deadline(deadline_heap[0]) <= clk) {
+			int bank_i = deadline_heap[0];
+			due.push_back(bank_i);
+			bank_refreshed[bank_i] = clk;
+			heap_update(bank_i);
 		}
+		sort(due.begin(), due.end());
+		for (auto bank_i : due)
+			inject_bank_refresh(bank_i);
 	}
-
-    int refresh_interval = ctrl->channel->spec->speed_entry.nREFI;
-
-    // Time to schedule a refresh
-    if ((clk - refreshed) >= refresh_interval) {
-      //inject_refresh(true);
-      // ALDRAM: update timing parameters based on temperatures
-      //ALDRAM::Temp current_temperature = ALDRAM::Temp::COLD;
-      //ctrl->update_temp(current_temperature);
-    }
+  }
+  long Refresh::next_refresh() {
+	return deadline(deadline_heap[0]);
   }
   // Set bank refresh interval based on temperature
   void Refresh::set_ref_interval(int bank_i, bool hot) {
@@ -69,16 +73,50 @@ namespace ramulator {
 	  } else {
 		bank_ref_interval[bank_i] = refresh_interval;
 	  }
+	 heap_update(bank_i);
+  }
+  bool Refresh::heap_before(int bank_a, int bank_b) const {
+	long a = deadline(bank_a), b = deadline(bank_b);
+	return a < b || (a == b && bank_a < bank_b);
+  }
+  void Refresh::heap_swap(int pos_a, int pos_b) {
+	swap(deadline_heap[pos_a], deadline_heap[pos_b]);
+	heap_pos[deadline_heap[pos_a]] = pos_a;
+	heap_pos[deadline_heap[pos_b]] = pos_b;
+  }
+  void Refresh::heap_update(int bank_i) {
+	int pos = heap_pos[bank_i];
+	// sift up
+	while (pos > 0 && heap_before(bank_i, deadline_heap[(pos - 1) / 2])) {
+		heap_swap(pos, (pos - 1) / 2);
+		pos = (pos - 1) / 2;
+	}
+	// sift down
+	while (true) {
+		int child = 2 * pos + 1;
+		if (child >= n_banks)
+			break;
+		if (child + 1 < n_banks && heap_before(deadline_heap[child + 1], deadline_heap[child]))
+			child++;
+		if (!heap_before(deadline_heap[child], bank_i))
+			break;
+		heap_swap(pos, child);
+		pos = child;
+	}
   }
   // Refresh based on the specified address
   void Refresh::refresh_target(RamController* ctrl, int rank, int bank, int sa)
   {
-    vector<int> addr_vec(int(Level::MAX), -1);
-    addr_vec[0] = ctrl->channel->id;
-    addr_vec[1] = rank;
-    addr_vec[2] = bank;
-    addr_vec[3] = sa;
-    RamRequest req(addr_vec, RamRequest::Type::REFRESH, NULL);
+    AddrVec addr_vec(int(Level::MAX), -1);
+    addr_vec[level_chan] = ctrl->channel->id;
+    addr_vec[level_rank] = rank;
+    // 'bank' counts across the pseudo channels and bank groups of the rank
+    if (bank >= 0)
+      ctrl->channel->spec->split_bank(bank, addr_vec.data());
+    if (level_sa >= 0)
+      addr_vec[level_sa] = sa;
+    RamRequest::Type type = (bank >= 0) ? RamRequest::Type::BANKREFRESH : RamRequest::Type::REFRESH;
+    RamRequest req(addr_vec, type, NULL);
     bool res = ctrl->enqueue(req);
     assert(res);
   }
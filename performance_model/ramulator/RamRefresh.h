@@ -28,7 +28,7 @@ using namespace ramulator;
 
 namespace ramulator {
 
-class HBM;
+class RamSpec;
 
 class RamController;
 
@@ -36,8 +36,8 @@ class Refresh {
 public:
   RamController* ctrl;
   long clk, refreshed;
-  long *bank_ref_interval;
-  long *bank_refreshed;
+  vector<long> bank_ref_interval;
+  vector<long> bank_refreshed;
   // Per-bank refresh counter to track the refresh progress for each rank
   vector<int> bank_ref_counters;
   int max_rank_count, max_bank_count;
@@ -52,13 +52,13 @@ public:
     // Clean up backlog
     for (unsigned int i = 0; i < bank_refresh_backlog.size(); i++)
       delete bank_refresh_backlog[i];
-	delete bank_ref_interval;
-	delete bank_refreshed;
   }
 
   // Basic refresh scheduling for all bank refresh that is applicable to all DRAM types
   void tick_ref();
   void set_ref_interval(int bank_i, bool hot);
+  // Clock of the next bank refresh injection
+  long next_refresh();
 
 private:
   // Keeping track of refresh status of every bank: + means ahead of schedule, - means behind schedule
@@ -72,6 +72,18 @@ private:
   int backlog_early_pull_threshold = -6;
   bool ctrl_write_mode = false;
 
+  // Banks ordered by refresh deadline (bank_refreshed + bank_ref_interval), earliest first,
+  // so a tick only looks at the head instead of polling every bank
+  vector<int> deadline_heap;
+  vector<int> heap_pos; // index of each bank in deadline_heap
+  long deadline(int bank_i) const {
+	return bank_refreshed[bank_i] + bank_ref_interval[bank_i];
+  }
+  bool heap_before(int bank_a, int bank_b) const;
+  void heap_swap(int pos_a, int pos_b);
+  // Restore the heap order after the deadline of a bank changed
+  void heap_update(int bank_i);
+
   // Refresh based on the specified address
   void refresh_target(RamController* ctrl, int rank, int bank, int sa);
 
@@ -1,6 +1,7 @@
 #ifndef __RAM_REQUEST_H
 #define __RAM_REQUEST_H
 
+#include <cassert>
 #include <vector>
 #include <functional>
 
@@ -9,13 +10,39 @@ using namespace std;
 namespace ramulator
 {
 
+// Address of each level (channel, rank, ...), stored inline so that
+// creating or copying a request never allocates
+class AddrVec
+{
+public:
+    static const int MaxLevels = 8;
+
+    AddrVec() : n(0) {}
+    AddrVec(int size, int val) : n(size) { assert(size <= MaxLevels); for (int i = 0; i < n; i++) v[i] = val; }
+
+    int size() const { return n; }
+    void resize(int size) { assert(size <= MaxLevels); n = size; }
+    int* data() { return v; }
+    const int* data() const { return v; }
+    int* begin() { return v; }
+    int* end() { return v + n; }
+    const int* begin() const { return v; }
+    const int* end() const { return v + n; }
+    int& operator[](int i) { return v[i]; }
+    const int& operator[](int i) const { return v[i]; }
+
+private:
+    int v[MaxLevels];
+    int n;
+};
+
 class RamRequest
 {
 public:
     bool is_first_command;
     long addr;
     // long addr_row;
-    vector<int> addr_vec;
+    AddrVec addr_vec;
     // specify which core this request sent from, for virtual address translation
     int coreid;
 
@@ -26,6 +53,7 @@ public:
         REFRESH,
         POWERDOWN,
         SELFREFRESH,
+        BANKREFRESH,  // of the bank in addr_vec, REF if the standard has no per-bank refresh
         EXTENSION,
         MAX
     } type;
@@ -41,7 +69,7 @@ public:
     RamRequest(long addr, Type type, function<void(RamRequest&)> callback, int coreid = 0)
         : is_first_command(true), addr(addr), coreid(coreid), type(type), callback(callback) {}
 
-    RamRequest(vector<int>& addr_vec, Type type, function<void(RamRequest&)> callback, int coreid = 0)
+    RamRequest(const AddrVec& addr_vec, Type type, function<void(RamRequest&)> callback, int coreid = 0)
         : is_first_command(true), addr_vec(addr_vec), coreid(coreid), type(type), callback(callback) {}
 
     RamRequest()
@@ -1,163 +1,180 @@
 #include "RamScheduler.h"
 namespace ramulator {
 
-RamScheduler::RamScheduler(RamController* ctrl) : ctrl(ctrl) {
-    // FCFS
-    compare[0] = [this] (ReqIter req1, ReqIter req2) {
-            if (req1->arrive <= req2->arrive) return req1;
-            return req2;};
-
-    // FRFCFS
-    compare[1] = [this] (ReqIter req1, ReqIter req2) {
-            bool ready1 = this->ctrl->is_ready(req1);
-            bool ready2 = this->ctrl->is_ready(req2);
-
-            if (ready1 ^ ready2) {
-                if (ready1) return req1;
-                return req2;
-            }
+template <RamScheduler::Type T>
+class RamSchedulerImpl : public RamScheduler
+{
+public:
+    RamSchedulerImpl(RamController* ctrl) : RamScheduler(ctrl, T) {}
 
-            if (req1->arrive <= req2->arrive) return req1;
-            return req2;};
+    ReqIter get_head(RingBuffer<RamRequest>& q)
+    {
+        if (!q.size())
+            return q.end();
+        scan(q);
 
-    // FRFCFS_CAP
-    compare[2] = [this] (ReqIter req1, ReqIter req2) {
-            bool ready1 = this->ctrl->is_ready(req1);
-            bool ready2 = this->ctrl->is_ready(req2);
+        unsigned int head = 0;
+        for (unsigned int i = 1; i < q.size(); i++)
+            head = compare(T, q, head, i);
 
-            ready1 = ready1 && (this->ctrl->rowtable->get_hits(req1->addr_vec) <= this->cap);
-            ready2 = ready2 && (this->ctrl->rowtable->get_hits(req2->addr_vec) <= this->cap);
+        if (T != Type::FRFCFS_PriorHit)
+            return ReqIter(&q, head);
 
-            if (ready1 ^ ready2) {
-                if (ready1) return req1;
-                return req2;
-            }
+        if (states[head].ready && states[head].hit)
+            return ReqIter(&q, head);
 
-            if (req1->arrive <= req2->arrive) return req1;
-            return req2;};
-    // FRFCFS_PriorHit
-    compare[3] = [this] (ReqIter req1, ReqIter req2) {
-            bool ready1 = this->ctrl->is_ready(req1) && this->ctrl->is_row_hit(req1);
-            bool ready2 = this->ctrl->is_ready(req2) && this->ctrl->is_row_hit(req2);
+        // a request whose next command is PRE must not close the bank
+        // (or subarray) of a row hit request
+        // TODO Here it assumes all DRAM standards use PRE to close a row
+        // It's better to make it more general.
+        int group_len = int(ctrl->channel->spec->scope[int(Command::PRE)]) + 1;
 
-            if (ready1 ^ ready2) {
-                if (ready1) return req1;
-                return req2;
+        // if we can't find proper request, we need to return q.end(),
+        // so that no command will be scheduled
+        bool found = false;
+        for (unsigned int i = 0; i < q.size(); i++) {
+            bool violate_hit = false;
+            if (!states[i].hit && states[i].open) {
+                // so the next instruction to be scheduled is PRE, might violate hit
+                const int* group = q[i].addr_vec.data();
+                for (unsigned int h = 0; h < q.size(); h++) {
+                    if (states[h].hit && equal(group, group + group_len, q[h].addr_vec.data())) {
+                        violate_hit = true;
+                        break;
+                    }
+                }
+            }
+            if (violate_hit)
+                continue;
+            // If it comes here, that means it won't violate any hit request
+            if (!found) {
+                head = i;
+                found = true;
+            } else {
+                head = compare(Type::FRFCFS, q, head, i);
             }
+        }
+        return found ? ReqIter(&q, head) : q.end();
+    }
 
-            if (req1->arrive <= req2->arrive) return req1;
-            return req2;};
-}
+private:
+    void scan(RingBuffer<RamRequest>& q)
+    {
+        RamDRAM* channel = ctrl->channel;
+        if (states.size() < q.size())
+            states.resize(q.size());
+        for (unsigned int i = 0; i < q.size(); i++) {
+            RamRequest& req = q[i];
+            ReqState& st = states[i];
+            const int* addr = req.addr_vec.data();
+            // the row hit/open checks are decided by the request type, not the first cmd
+            Command req_cmd = channel->spec->translate[int(req.type)];
+            st.cmd = channel->decode(req_cmd, addr);
+            st.ready = channel->check(st.cmd, addr, ctrl->clk);
+            if (T == Type::FRFCFS_PriorHit) {
+                st.hit = channel->check_row_hit(req_cmd, addr);
+                st.open = st.hit || channel->check_row_open(req_cmd, addr);
+            }
+            if (T == Type::FRFCFS_Cap)
+                st.capped = ctrl->rowtable->get_hits(addr) > cap;
+            if (T != Type::FCFS && group_aware)
+                st.other_group = channel->spec->group_index(addr) != ctrl->last_cas_group;
+        }
+    }
 
-    list<RamRequest>::iterator RamScheduler::get_head(list<RamRequest>& q)
+    // The preferred of requests i and j under policy 'type', the older one on ties
+    unsigned int compare(Type type, RingBuffer<RamRequest>& q, unsigned int i, unsigned int j) const
     {
-      // TODO make the decision at compile time
-      if (type != Type::FRFCFS_PriorHit) {
-        if (!q.size())
-            return q.end();
+        if (type != Type::FCFS) {
+            bool ready1 = states[i].ready, ready2 = states[j].ready;
+            if (type == Type::FRFCFS_Cap) {
+                ready1 = ready1 && !states[i].capped;
+                ready2 = ready2 && !states[j].capped;
+            } else if (type == Type::FRFCFS_PriorHit) {
+                ready1 = ready1 && states[i].hit;
+                ready2 = ready2 && states[j].hit;
+            }
+            if (ready1 ^ ready2)
+                return ready1 ? i : j;
+            if (group_aware && ready1 && (states[i].other_group ^ states[j].other_group))
+                return states[i].other_group ? i : j;
+        }
+        return (q[i].arrive <= q[j].arrive) ? i : j;
+    }
+};
 
-        auto head = q.begin();
-        for (auto itr = next(q.begin(), 1); itr != q.end(); itr++)
-            head = compare[int(type)](head, itr);
+RamScheduler::RamScheduler(RamController* ctrl, Type type) : ctrl(ctrl), type(type)
+{
+    group_aware = ctrl->channel->spec->org_entry.count[int(Level::BankGroup)] > 1;
+}
 
-        return head;
-      } else {
-        if (!q.size())
-            return q.end();
+RamScheduler* RamScheduler::create(RamController* ctrl, Type type)
+{
+    switch (type) {
+        case Type::FCFS: return new RamSchedulerImpl<Type::FCFS>(ctrl);
+        case Type::FRFCFS: return new RamSchedulerImpl<Type::FRFCFS>(ctrl);
+        case Type::FRFCFS_Cap: return new RamSchedulerImpl<Type::FRFCFS_Cap>(ctrl);
+        default: return new RamSchedulerImpl<Type::FRFCFS_PriorHit>(ctrl);
+    }
+}
 
-        auto head = q.begin();
-        for (auto itr = next(q.begin(), 1); itr != q.end(); itr++) {
-            head = compare[int(Type::FRFCFS_PriorHit)](head, itr);
-        }
+RamScheduler::Type RamScheduler::parse(const std::string& name)
+{
+    if (name == "FCFS") return Type::FCFS;
+    if (name == "FRFCFS") return Type::FRFCFS;
+    if (name == "FRFCFS_Cap") return Type::FRFCFS_Cap;
+    return Type::FRFCFS_PriorHit;
+}
 
-        if (this->ctrl->is_ready(head) && this->ctrl->is_row_hit(head)) {
-          return head;
-        }
+template <RowPolicy::Type T>
+class RowPolicyImpl : public RowPolicy
+{
+public:
+    RowPolicyImpl(RamController* ctrl) : RowPolicy(ctrl, T) {}
 
-        // prepare a list of hit request
-        vector<vector<int>> hit_reqs;
-        for (auto itr = q.begin() ; itr != q.end() ; ++itr) {
-          if (this->ctrl->is_row_hit(itr)) {
-            auto begin = itr->addr_vec.begin();
-            // TODO Here it assumes all DRAM standards use PRE to close a row
-            // It's better to make it more general.
-            auto end = begin + int(ctrl->channel->spec->scope[int(Command::PRE)]) + 1;
-            vector<int> rowgroup(begin, end); // bank or subarray
-            hit_reqs.push_back(rowgroup);
-          }
-        }
-        // if we can't find proper request, we need to return q.end(),
-        // so that no command will be scheduled
-        head = q.end();
-        for (auto itr = q.begin(); itr != q.end(); itr++) {
-          bool violate_hit = false;
-          if ((!this->ctrl->is_row_hit(itr)) && this->ctrl->is_row_open(itr)) {
-            // so the next instruction to be scheduled is PRE, might violate hit
-            auto begin = itr->addr_vec.begin();
-            // TODO Here it assumes all DRAM standards use PRE to close a row
-            // It's better to make it more general.
-            auto end = begin + int(ctrl->channel->spec->scope[int(Command::PRE)]) + 1;
-            vector<int> rowgroup(begin, end); // bank or subarray
-            for (const auto& hit_req_rowgroup : hit_reqs) {
-              if (rowgroup == hit_req_rowgroup) {
-                  violate_hit = true;
-                  break;
-              }
-            }
-          }
-          if (violate_hit) {
-            continue;
-          }
-          // If it comes here, that means it won't violate any hit request
-          if (head == q.end()) {
-            head = itr;
-          } else {
-            head = compare[int(Type::FRFCFS)](head, itr);
-          }
+    vector<int> get_victim(Command cmd)
+    {
+        if (T == Type::Opened)
+            return vector<int>();
+
+        for (auto& kv : ctrl->rowtable->table) {
+            if (T == Type::Timeout && ctrl->clk - kv.second.timestamp < timeout)
+                continue;
+            if (!ctrl->is_ready(cmd, kv.first.data()))
+                continue;
+            return kv.first;
         }
-
-        return head;
-      }
+        return vector<int>();
+    }
+};
+
+RowPolicy* RowPolicy::create(RamController* ctrl, Type type)
+{
+    switch (type) {
+        case Type::Closed: return new RowPolicyImpl<Type::Closed>(ctrl);
+        case Type::Timeout: return new RowPolicyImpl<Type::Timeout>(ctrl);
+        default: return new RowPolicyImpl<Type::Opened>(ctrl);
     }
+}
 
-RowPolicy::RowPolicy(RamController* ctrl) : ctrl(ctrl) {
-    // Closed
-    policy[0] = [this] (Command cmd) -> vector<int> {
-            for (auto& kv : this->ctrl->rowtable->table) {
-                if (!this->ctrl->is_ready(cmd, kv.first))
-                    continue;
-                return kv.first;
-            }
-            return vector<int>();};
-
-    // Opened
-    policy[1] = [this] (Command cmd) {
-            return vector<int>();};
-
-    // Timeout
-    policy[2] = [this] (Command cmd) -> vector<int> {
-            for (auto& kv : this->ctrl->rowtable->table) {
-                auto& entry = kv.second;
-                if (this->ctrl->clk - entry.timestamp < timeout)
-                    continue;
-                if (!this->ctrl->is_ready(cmd, kv.first))
-                    continue;
-                return kv.first;
-            }
-            return vector<int>();};
+RowPolicy::Type RowPolicy::parse(const std::string& name)
+{
+    if (name == "Closed") return Type::Closed;
+    if (name == "Timeout") return Type::Timeout;
+    return Type::Opened;
 }
 
 RowTable::RowTable(RamController* ctrl) : ctrl(ctrl) {
 }
 
-    void RowTable::update(Command cmd, const vector<int>& addr_vec, long clk)
+    void RowTable::update(Command cmd, const int* addr_vec, long clk)
     {
-        auto begin = addr_vec.begin();
+        auto begin = addr_vec;
         auto end = begin + int(Level::Row);
         vector<int> rowgroup(begin, end); // bank or subarray
         int row = *end;
 
-        HBM* spec = ctrl->channel->spec;
+        RamSpec* spec = ctrl->channel->spec;
 
         if (spec->is_opening(cmd))
             table.insert({rowgroup, {row, 0, clk}});
@@ -187,9 +204,9 @@ RowTable::RowTable(RamController* ctrl) : ctrl(ctrl) {
         } /* closing */
     }
 
-    int RowTable::get_hits(vector<int>& addr_vec)
+    int RowTable::get_hits(const int* addr_vec)
     {
-        auto begin = addr_vec.begin();
+        auto begin = addr_vec;
         auto end = begin + int(Level::Row);
 
         vector<int> rowgroup(begin, end);
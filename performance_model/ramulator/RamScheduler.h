@@ -4,13 +4,15 @@
 #include "RamDRAM.h"
 #include "RamRequest.h"
 #include "RamController.h"
+#include "RamQueue.h"
 #include <vector>
 #include <map>
 #include <list>
 #include <functional>
 #include <cassert>
+#include <string>
 
-#include "HBM.h"
+#include "RamSpec.h"
 
 using namespace std;
 
@@ -19,6 +21,16 @@ namespace ramulator
 
 class RamController;
 
+/*
+ * Picks the queued request whose commands are issued next
+ *   The policy is a template parameter of the implementation, chosen once
+ *   by create(), so the comparisons of a queue scan are inlined.
+ *   Each scan decodes the first command of every request and checks its
+ *   readiness once; the controller reuses these results for the head.
+ *   With bank groups, the FR-FCFS policies prefer, among requests that are
+ *   equally ready, one outside the group of the last access, whose next
+ *   access only waits tCCD_S instead of tCCD_L.
+ */
 class RamScheduler
 {
 public:
@@ -26,20 +38,44 @@ public:
 
     enum class Type {
         FCFS, FRFCFS, FRFCFS_Cap, FRFCFS_PriorHit, MAX
-    } type = Type::FRFCFS_PriorHit;
+    } type;
 
     long cap = 16;
 
-    RamScheduler(RamController* ctrl);
+    typedef RingBuffer<RamRequest>::iterator ReqIter;
 
-    list<RamRequest>::iterator get_head(list<RamRequest>& q);
+    static RamScheduler* create(RamController* ctrl, Type type);
+    static Type parse(const std::string& name);
 
-private:
-    typedef list<RamRequest>::iterator ReqIter;
-    function<ReqIter(ReqIter, ReqIter)> compare[int(Type::MAX)];
+    virtual ~RamScheduler() {}
+
+    virtual ReqIter get_head(RingBuffer<RamRequest>& q) = 0;
+
+    // First command and readiness of a request of the last scan
+    Command first_cmd(ReqIter req) const { return states[req.index()].cmd; }
+    bool is_ready(ReqIter req) const { return states[req.index()].ready; }
+
+protected:
+    RamScheduler(RamController* ctrl, Type type);
+
+    bool group_aware;  // more than one bank group per pseudo channel
+
+    // per request results of a scan, valid until a command is issued
+    struct ReqState {
+        Command cmd;
+        bool ready;
+        bool hit;  // FRFCFS_PriorHit only
+        bool open;  // FRFCFS_PriorHit only
+        bool capped;  // FRFCFS_Cap only
+        bool other_group;  // not in the bank group of the last access, group_aware only
+    };
+    vector<ReqState> states;
 };
 
 
+/*
+ * Speculative precharge of open rows, chosen once by create()
+ */
 class RowPolicy
 {
 public:
@@ -47,19 +83,19 @@ public:
 
     enum class Type {
         Closed, Opened, Timeout, MAX
-    } type = Type::Opened;
+    } type;
 
     int timeout = 50;
 
-    RowPolicy(RamController* ctrl);
+    static RowPolicy* create(RamController* ctrl, Type type);
+    static Type parse(const std::string& name);
+
+    virtual ~RowPolicy() {}
 
-    vector<int> get_victim(Command cmd)
-    {
-        return policy[int(type)](cmd);
-    }
+    virtual vector<int> get_victim(Command cmd) = 0;
 
-private:
-    function<vector<int>(Command)> policy[int(Type::MAX)];
+protected:
+    RowPolicy(RamController* ctrl, Type type) : ctrl(ctrl), type(type) {}
 };
 
 
@@ -78,9 +114,9 @@ public:
 
     RowTable(RamController* ctrl);
 
-    void update(Command cmd, const vector<int>& addr_vec, long clk);
+    void update(Command cmd, const int* addr_vec, long clk);
     
-    int get_hits(vector<int>& addr_vec);
+    int get_hits(const int* addr_vec);
 };
 
 } /*namespace ramulator*/
@@ -0,0 +1,230 @@
+/*
+ * RamSpec.cc
+ *
+ * Standard selection and the lambdas shared by the DDR family
+ * (HBM, HBM2, DDR3, DDR4): power-down, self refresh, one open row per bank.
+ */
+
+#include "RamSpec.h"
+#include "RamDRAM.h"
+#include "HBM.h"
+#include "HBM2.h"
+#include "DDR3.h"
+#include "DDR4.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+using namespace ramulator;
+
+RamSpec* RamSpec::create(const string& standard, const string& org, const string& speed)
+{
+    if (standard == "" || standard == "HBM")
+        return new HBM(org, speed);
+    if (standard == "HBM2")
+        return new HBM2(org, speed);
+    if (standard == "DDR3")
+        return new DDR3(org, speed);
+    if (standard == "DDR4")
+        return new DDR4(org, speed);
+
+    cerr << "[RAMULATOR] Unsupported standard " << standard
+         << ", choose HBM, HBM2, DDR3 or DDR4" << endl;
+    assert(false);
+    return NULL;
+}
+
+void RamSpec::set_channel_number(int channel) {
+  org_entry.count[int(Level::Channel)] = channel;
+}
+
+void RamSpec::set_rank_number(int rank) {
+  org_entry.count[int(Level::Rank)] = rank;
+}
+
+bool RamSpec::any_bank_open(RamDRAM* rank)
+{
+    for (auto pc : rank->children)
+        for (auto bg : pc->children)
+            for (auto bank : bg->children)
+                if (bank->state != State::Closed)
+                    return true;
+    return false;
+}
+
+void RamSpec::close_banks(RamDRAM* rank)
+{
+    for (auto pc : rank->children)
+        for (auto bg : pc->children)
+            for (auto bank : bg->children) {
+                bank->state = State::Closed;
+                bank->open_row = -1;
+            }
+}
+
+void RamSpec::init_prereq()
+{
+    // RD
+    prereq[int(Level::Rank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
+        switch (int(node->state)) {
+            case int(State::PowerUp): return Command::MAX;
+            case int(State::ActPowerDown): return Command::PDX;
+            case int(State::PrePowerDown): return Command::PDX;
+            case int(State::SelfRefresh): return Command::SRX;
+            default: assert(false);
+        }};
+    prereq[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
+        switch (int(node->state)) {
+            case int(State::Closed): return Command::ACT;
+            case int(State::Opened):
+                if (node->open_row == id)
+                    return cmd;
+                else return Command::PRE;
+            default: assert(false);
+        }};
+
+    // WR
+    prereq[int(Level::Rank)][int(Command::WR)] = prereq[int(Level::Rank)][int(Command::RD)];
+    prereq[int(Level::Bank)][int(Command::WR)] = prereq[int(Level::Bank)][int(Command::RD)];
+
+    // REF
+    prereq[int(Level::Rank)][int(Command::REF)] = [] (RamDRAM* node, Command cmd, int id) {
+        if (any_bank_open(node))
+            return Command::PREA;
+        return Command::REF;};
+
+    // PD
+    prereq[int(Level::Rank)][int(Command::PDE)] = [] (RamDRAM* node, Command cmd, int id) {
+        switch (int(node->state)) {
+            case int(State::PowerUp): return Command::PDE;
+            case int(State::ActPowerDown): return Command::PDE;
+            case int(State::PrePowerDown): return Command::PDE;
+            case int(State::SelfRefresh): return Command::SRX;
+            default: assert(false);
+        }};
+
+    // SR
+    prereq[int(Level::Rank)][int(Command::SRE)] = [] (RamDRAM* node, Command cmd, int id) {
+        switch (int(node->state)) {
+            case int(State::PowerUp): return Command::SRE;
+            case int(State::ActPowerDown): return Command::PDX;
+            case int(State::PrePowerDown): return Command::PDX;
+            case int(State::SelfRefresh): return Command::SRE;
+            default: assert(false);
+        }};
+}
+
+// SAUGATA: added row hit check functions to see if the desired location is currently open
+void RamSpec::init_rowhit()
+{
+    // RD
+    rowhit[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
+        switch (int(node->state)) {
+            case int(State::Closed): return false;
+            case int(State::Opened):
+                if (node->open_row == id)
+                    return true;
+                return false;
+            default: assert(false);
+        }};
+
+    // WR
+    rowhit[int(Level::Bank)][int(Command::WR)] = rowhit[int(Level::Bank)][int(Command::RD)];
+}
+
+void RamSpec::init_rowopen()
+{
+    // RD
+    rowopen[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, Command cmd, int id) {
+        switch (int(node->state)) {
+            case int(State::Closed): return false;
+            case int(State::Opened): return true;
+            default: assert(false);
+        }};
+
+    // WR
+    rowopen[int(Level::Bank)][int(Command::WR)] = rowopen[int(Level::Bank)][int(Command::RD)];
+}
+
+void RamSpec::init_lambda()
+{
+    lambda[int(Level::Bank)][int(Command::ACT)] = [] (RamDRAM* node, int id) {
+        node->state = State::Opened;
+        node->open_row = id;};
+    lambda[int(Level::Bank)][int(Command::PRE)] = [] (RamDRAM* node, int id) {
+        node->state = State::Closed;
+        node->open_row = -1;};
+    lambda[int(Level::Rank)][int(Command::PREA)] = [] (RamDRAM* node, int id) {
+        close_banks(node);};
+    lambda[int(Level::Rank)][int(Command::REF)] = [] (RamDRAM* node, int id) {};
+    lambda[int(Level::Bank)][int(Command::RD)] = [] (RamDRAM* node, int id) {};
+    lambda[int(Level::Bank)][int(Command::WR)] = [] (RamDRAM* node, int id) {};
+    lambda[int(Level::Bank)][int(Command::RDA)] = [] (RamDRAM* node, int id) {
+        node->state = State::Closed;
+        node->open_row = -1;};
+    lambda[int(Level::Bank)][int(Command::WRA)] = [] (RamDRAM* node, int id) {
+        node->state = State::Closed;
+        node->open_row = -1;};
+    lambda[int(Level::Rank)][int(Command::PDE)] = [] (RamDRAM* node, int id) {
+        if (any_bank_open(node))
+            node->state = State::ActPowerDown;
+        else
+            node->state = State::PrePowerDown;};
+    lambda[int(Level::Rank)][int(Command::PDX)] = [] (RamDRAM* node, int id) {
+        node->state = State::PowerUp;};
+    lambda[int(Level::Rank)][int(Command::SRE)] = [] (RamDRAM* node, int id) {
+        node->state = State::SelfRefresh;};
+    lambda[int(Level::Rank)][int(Command::SRX)] = [] (RamDRAM* node, int id) {
+        node->state = State::PowerUp;};
+}
+
+void RamSpec::init_bank_timing(vector<TimingEntry>* t, const SpeedEntry& s)
+{
+    // CAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::RD, 1, s.nRCDR});
+    t[int(Command::ACT)].push_back({Command::RDA, 1, s.nRCDR});
+    t[int(Command::ACT)].push_back({Command::WR, 1, s.nRCDW});
+    t[int(Command::ACT)].push_back({Command::WRA, 1, s.nRCDW});
+
+    t[int(Command::RD)].push_back({Command::PRE, 1, s.nRTP});
+    t[int(Command::WR)].push_back({Command::PRE, 1, s.nCWL + s.nBL + s.nWR});
+
+    t[int(Command::RDA)].push_back({Command::ACT, 1, s.nRTP + s.nRP});
+    t[int(Command::WRA)].push_back({Command::ACT, 1, s.nCWL + s.nBL + s.nWR + s.nRP});
+
+    // RAS <-> RAS
+    t[int(Command::ACT)].push_back({Command::ACT, 1, s.nRC});
+    t[int(Command::ACT)].push_back({Command::PRE, 1, s.nRAS});
+    t[int(Command::PRE)].push_back({Command::ACT, 1, s.nRP});
+}
+
+void RamSpec::init_temp_timing()
+{
+    // Scale of tRCD, tRAS, tWR, tRP per temperature class: the average
+    // reductions AL-DRAM (Lee et al., HPCA'15) measured at 55C for Cold,
+    // a 10% guardband for Hot
+    const static double SCALE_TABLE[int(Temp::MAX)][4] = {
+        {0.827, 0.623, 0.452, 0.648},
+        {1.0, 1.0, 1.0, 1.0},
+        {1.1, 1.1, 1.1, 1.1}
+    };
+    auto scale = [] (int n, double f) {
+        return max(1, int(ceil(n * f - 1e-6)));
+    };
+
+    for (int temp = 0; temp < int(Temp::MAX); temp++) {
+        const double* f = SCALE_TABLE[temp];
+        SpeedEntry s = speed_entry;
+        s.nRCDR = scale(speed_entry.nRCDR, f[0]);
+        s.nRCDW = scale(speed_entry.nRCDW, f[0]);
+        s.nRAS = scale(speed_entry.nRAS, f[1]);
+        s.nWR = scale(speed_entry.nWR, f[2]);
+        s.nRP = scale(speed_entry.nRP, f[3]);
+        // tRC is tRAS + tRP, keep whatever margin a standard adds
+        s.nRC = speed_entry.nRC - speed_entry.nRAS - speed_entry.nRP + s.nRAS + s.nRP;
+        init_bank_timing(temp_timing[temp], s);
+    }
+}
@@ -0,0 +1,269 @@
+#ifndef __RAM_SPEC_H
+#define __RAM_SPEC_H
+
+#include "RamRequest.h"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+
+using namespace std;
+
+namespace ramulator
+{
+    /* Level */
+    // Union of the levels of all standards: a standard without pseudo
+    // channels or bank groups has a single one per parent, which adds no
+    // address bit and no timing
+    enum class Level : int
+    {
+        Channel, Rank, PseudoChannel, BankGroup, Bank, Row, Column, MAX
+    };
+
+    /* Command */
+    // Union of the commands of all standards, REFSB is HBM only
+    enum class Command : int
+    {
+        ACT, PRE,   PREA,
+        RD,  WR,    RDA, WRA,
+        REF, REFSB, PDE, PDX,  SRE, SRX,
+        MAX
+    };
+    /* State */
+    enum class State : int
+    {
+        Opened, Closed, PowerUp, ActPowerDown, PrePowerDown, SelfRefresh, MAX
+    };
+    /* Timing */
+    struct TimingEntry
+    {
+        Command cmd;
+        int dist;
+        int val;
+        bool sibling;
+    };
+
+class RamDRAM;
+
+/*
+ * Specification of a DRAM standard (e.g., HBM, DDR4)
+ *   A standard fills the organization and speed entries and the per level,
+ *   per command tables below once, at construction. The DRAM tree and the
+ *   controllers only index these tables, so which standard is simulated
+ *   never shows up as a branch when a command is checked or issued.
+ *   The prerequisite, row hit and state lambdas of the DDR family are
+ *   shared here, a standard only adds its own ones.
+ */
+class RamSpec
+{
+public:
+    string standard_name;
+
+    virtual ~RamSpec() {}
+
+    // Construct the standard named in the config ("standard", "org", "speed")
+    static RamSpec* create(const string& standard, const string& org, const string& speed);
+
+    string command_name[int(Command::MAX)] = {
+        "ACT", "PRE",   "PREA",
+        "RD",  "WR",    "RDA",  "WRA",
+        "REF", "REFSB", "PDE",  "PDX",  "SRE", "SRX"
+    };
+
+    Level scope[int(Command::MAX)] = {
+        Level::Row,    Level::Bank,   Level::Rank,
+        Level::Column, Level::Column, Level::Column, Level::Column,
+        Level::Rank,   Level::Bank,   Level::Rank,   Level::Rank,   Level::Rank,   Level::Rank
+    };
+
+    bool is_opening(Command cmd)
+    {
+        switch(int(cmd)) {
+            case int(Command::ACT):
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool is_accessing(Command cmd)
+    {
+        switch(int(cmd)) {
+            case int(Command::RD):
+            case int(Command::WR):
+            case int(Command::RDA):
+            case int(Command::WRA):
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool is_closing(Command cmd)
+    {
+        switch(int(cmd)) {
+            case int(Command::RDA):
+            case int(Command::WRA):
+            case int(Command::PRE):
+            case int(Command::PREA):
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool is_refreshing(Command cmd)
+    {
+        switch(int(cmd)) {
+            case int(Command::REF):
+            case int(Command::REFSB):
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /* State */
+    State start[int(Level::MAX)] = {
+        State::MAX, State::PowerUp, State::MAX, State::MAX, State::Closed, State::Closed, State::MAX
+    };
+
+    /* Translate */
+    Command translate[int(RamRequest::Type::MAX)] = {
+        Command::RD,  Command::WR,
+        Command::REF, Command::PDE, Command::SRE,
+        Command::REF
+    };
+
+    /* Prereq */
+    function<Command(RamDRAM*, Command cmd, int)> prereq[int(Level::MAX)][int(Command::MAX)];
+
+    // SAUGATA: added function object container for row hit status
+    /* Row hit */
+    function<bool(RamDRAM*, Command cmd, int)> rowhit[int(Level::MAX)][int(Command::MAX)];
+    function<bool(RamDRAM*, Command cmd, int)> rowopen[int(Level::MAX)][int(Command::MAX)];
+
+    vector<TimingEntry> timing[int(Level::MAX)][int(Command::MAX)];
+
+    /* Temperature */
+    // AL-DRAM: a cool bank has more charge margin than the worst case the
+    // standard timings are set for, so its tRCD, tRAS, tWR and tRP can be
+    // shortened; a bank beyond the normal range gets a guardband instead
+    enum class Temp : int
+    {
+        Cold, Normal, Hot, MAX
+    };
+    // Bank level timing per temperature class, Normal is timing[Bank]
+    vector<TimingEntry> temp_timing[int(Temp::MAX)][int(Command::MAX)];
+
+    /* Lambda */
+    function<void(RamDRAM*, int)> lambda[int(Level::MAX)][int(Command::MAX)];
+
+    struct OrgEntry {
+        int size;
+        int dq;
+        int count[int(Level::MAX)];
+    } org_entry;
+
+    void set_channel_number(int channel);
+    void set_rank_number(int rank);
+
+    // Banks of a rank, across its pseudo channels and bank groups
+    int banks_per_rank() const
+    {
+        return org_entry.count[int(Level::PseudoChannel)] * org_entry.count[int(Level::BankGroup)]
+                * org_entry.count[int(Level::Bank)];
+    }
+
+    // Index of the addressed bank group in its channel, rank major
+    int group_index(const int* addr_vec) const
+    {
+        return (addr_vec[int(Level::Rank)] * org_entry.count[int(Level::PseudoChannel)]
+                + addr_vec[int(Level::PseudoChannel)]) * org_entry.count[int(Level::BankGroup)]
+                + addr_vec[int(Level::BankGroup)];
+    }
+
+    // Index of the addressed bank in its channel, rank major
+    int bank_index(const int* addr_vec) const
+    {
+        return group_index(addr_vec) * org_entry.count[int(Level::Bank)] + addr_vec[int(Level::Bank)];
+    }
+
+    // Split a bank index of a rank (as bank_index() counts them) into addr_vec
+    void split_bank(int bank, int* addr_vec) const
+    {
+        const int* sz = org_entry.count;
+        addr_vec[int(Level::Bank)] = bank % sz[int(Level::Bank)];
+        bank /= sz[int(Level::Bank)];
+        addr_vec[int(Level::BankGroup)] = bank % sz[int(Level::BankGroup)];
+        addr_vec[int(Level::PseudoChannel)] = bank / sz[int(Level::BankGroup)];
+    }
+
+    int prefetch_size;
+    int channel_width;
+
+    // Timings in DRAM cycles, a standard leaves the ones it does not have at 0
+    struct SpeedEntry {
+        int rate;
+        double freq, tCK;
+        int nBL, nCCDS, nCCDL;
+        int nCL, nRCDR, nRCDW, nRP, nCWL;
+        int nRAS, nRC;
+        int nRTP, nWTRS, nWTRL, nWR;
+        int nRRDS, nRRDL, nFAW;
+        int nRFC, nREFI, nREFI1B;
+        int nPD, nXP;
+        int nCKESR, nXS;
+        int nRTRS, nXPDLL, nXSDLL;
+        int nRFCSB;
+    } speed_entry;
+
+    int read_latency;
+
+protected:
+    RamSpec() {}
+
+    // Look up an org or speed name of the config
+    template <typename T>
+    static T parse(const map<string, T>& names, const string& name, const char* what)
+    {
+        auto it = names.find(name);
+        if (it == names.end()) {
+            cerr << "[RAMULATOR] Unknown " << what << " " << name << endl;
+            assert(false);
+        }
+        return it->second;
+    }
+
+    // Cycles of a timing given in ns, at least 'min_nck'
+    static int nck(double ns, double tCK, int min_nck = 0)
+    {
+        int n = int(ns / tCK);
+        if (n * tCK < ns - 1e-6)
+            n++;
+        return n > min_nck ? n : min_nck;
+    }
+
+    // Is a bank of the rank open, close all of them
+    static bool any_bank_open(RamDRAM* rank);
+    static void close_banks(RamDRAM* rank);
+
+    // Bank level timing of the DDR family for speed 's', a standard adds its own
+    virtual void init_bank_timing(vector<TimingEntry>* t, const SpeedEntry& s);
+    // Fill temp_timing from the speed entry, after init_timing()
+    void init_temp_timing();
+
+    // Lambdas common to the DDR family
+    void init_prereq();
+    void init_rowhit();  // SAUGATA: added function to check for row hits
+    void init_rowopen();
+    void init_lambda();
+};
+
+} /*namespace ramulator*/
+
+#endif /*__RAM_SPEC_H*/
@@ -0,0 +1,97 @@
+#ifndef __RAM_WORKERS_H
+#define __RAM_WORKERS_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ramulator
+{
+
+/*
+ * Fixed pool of worker threads
+ *   run(task) calls task(0) .. task(n - 1) concurrently, task(0) on the
+ *   calling thread, and returns once all of them have finished.
+ *   The workers sleep on a condition variable between two runs.
+ */
+class RamWorkers
+{
+public:
+    RamWorkers(int n)
+        : n(n), generation(0), running(0), stop(false)
+    {
+        for (int i = 1; i < n; i++)
+            threads.push_back(std::thread(&RamWorkers::worker, this, i));
+    }
+
+    ~RamWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv_start.notify_all();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    int size() const { return n; }
+
+    void run(const std::function<void(int)>& f)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            task = &f;
+            running = n - 1;
+            generation++;
+        }
+        cv_start.notify_all();
+
+        f(0);
+
+        std::unique_lock<std::mutex> lock(m);
+        cv_done.wait(lock, [this] { return running == 0; });
+        task = NULL;
+    }
+
+private:
+    int n;
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable cv_start, cv_done;
+    const std::function<void(int)>* task = NULL;
+    long generation;
+    int running;
+    bool stop;
+
+    RamWorkers(const RamWorkers&);
+    RamWorkers& operator=(const RamWorkers&);
+
+    void worker(int i)
+    {
+        long seen = 0;
+        while (true) {
+            const std::function<void(int)>* f;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv_start.wait(lock, [this, seen] { return stop || generation != seen; });
+                if (stop)
+                    return;
+                seen = generation;
+                f = task;
+            }
+
+            (*f)(i);
+
+            std::lock_guard<std::mutex> lock(m);
+            if (--running == 0)
+                cv_done.notify_one();
+        }
+    }
+};
+
+} /*namespace ramulator*/
+
+#endif /*__RAM_WORKERS_H*/
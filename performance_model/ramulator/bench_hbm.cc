@@ -0,0 +1,86 @@
+/*
+ * Command-stream microbenchmark of the ramulator channel model
+ *   Drives a synthetic stream of reads and writes to random banks, rows and
+ *   columns straight into a RamDRAM channel tree, decoding each request to
+ *   its next command and issuing it when the timing allows, one attempt per
+ *   DRAM cycle. Reports the commands issued per second of host time, which
+ *   is dominated by check()/update() of the row state and command history.
+ *
+ *   Build (from performance_model/ramulator):
+ *     g++ -O2 -std=c++11 -I. bench_hbm.cc RamDRAM.cc RamSpec.cc RamStatType.cc \
+ *         HBM.cc HBM2.cc DDR3.cc DDR4.cc -o bench_hbm
+ *   Run:
+ *     ./bench_hbm [standard org speed [cycles]]
+ *     (default: HBM HBM_4Gb HBM_1Gbps, 20M cycles)
+ *   The org and speed names belong to the standard, so the three are given
+ *   together or not at all.
+ */
+#include "RamDRAM.h"
+#include "RamSpec.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+using namespace ramulator;
+
+int main(int argc, char** argv)
+{
+    if (argc == 2 || argc == 3 || argc > 5) {
+        fprintf(stderr, "usage: %s [standard org speed [cycles]]\n", argv[0]);
+        return 1;
+    }
+    string standard = argc > 3 ? argv[1] : "HBM";
+    string org = argc > 3 ? argv[2] : "HBM_4Gb";
+    string speed = argc > 3 ? argv[3] : "HBM_1Gbps";
+    long cycles = argc > 4 ? atol(argv[4]) : 20000000;
+
+    RamSpec* spec = RamSpec::create(standard, org, speed);
+    spec->set_channel_number(1);
+    spec->set_rank_number(4);
+    RamDRAM* channel = new RamDRAM(spec, Level::Channel);
+
+    const int* sz = spec->org_entry.count;
+    int n_banks = spec->banks_per_rank();
+    int n_rows = sz[int(Level::Row)] < 16 ? sz[int(Level::Row)] : 16;
+
+    // pre-generated, so that the loop only measures the channel model
+    const int N = 1 << 16;
+    static int trace[N][int(Level::MAX)];
+    static bool is_write[N];
+    srand(3);
+    for (int i = 0; i < N; i++) {
+        int* addr = trace[i];
+        addr[int(Level::Channel)] = 0;
+        addr[int(Level::Rank)] = rand() % sz[int(Level::Rank)];
+        spec->split_bank(rand() % n_banks, addr);
+        addr[int(Level::Row)] = rand() % n_rows;
+        addr[int(Level::Column)] = rand() % 32;
+        is_write[i] = rand() % 3 == 0;
+    }
+
+    long cmds = 0, hits = 0;
+    auto start = chrono::steady_clock::now();
+    for (long clk = 0; clk < cycles; clk++) {
+        int k = clk & (N - 1);
+        Command req = is_write[k] ? Command::WR : Command::RD;
+        hits += channel->check_row_hit(req, trace[k]);
+        Command cmd = channel->decode(req, trace[k]);
+        if (channel->check(cmd, trace[k], clk)) {
+            channel->update(cmd, trace[k], clk);
+            cmds++;
+        }
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("%s %s %s: %ld cycles, %ld commands, %ld row hits\n",
+           standard.c_str(), org.c_str(), speed.c_str(), cycles, cmds, hits);
+    printf("%.2f s, %.1f M cycles/s, %.2f M commands/s\n",
+           sec, cycles / sec / 1e6, cmds / sec / 1e6);
+
+    delete channel;
+    delete spec;
+    return 0;
+}
@@ -7,15 +7,15 @@ DramModel::DramModel()
 DramModel::DramModel(const std::string& fname)
 {
 	configs = new RamConfig(fname);
-	hbm = new HBM(configs->getPara("org"), configs->getPara("speed"));
+	spec = RamSpec::create(configs->getPara("standard"), configs->getPara("org"), configs->getPara("speed"));
 	C = configs->get_channels(); R = configs->get_ranks();
-	hbm->set_channel_number(C);
-	hbm->set_rank_number(R);
-	freq = hbm->speed_entry.freq;
-	tCK = hbm->speed_entry.tCK;
+	spec->set_channel_number(C);
+	spec->set_rank_number(R);
+	freq = spec->speed_entry.freq;
+	tCK = spec->speed_entry.tCK;
 
 	for (int c = 0; c < C; c++) {
-		RamDRAM* channel = new RamDRAM(hbm, Level::Channel);
+		RamDRAM* channel = new RamDRAM(spec, Level::Channel);
 		channel->id = c;
 		channel->regStats("");
 		RamController* ctlr = new RamController(*configs, channel);
@@ -30,8 +30,6 @@ DramModel::DramModel(const std::string& fname)
 	interval_ticks = 500000;
 	tot_ticks = 0;
 
-	/* */
-	recent_read_latency = recent_write_latency = memory->spec->read_latency;
 }
 
 DramModel::~DramModel()
@@ -40,6 +38,8 @@ DramModel::~DramModel()
 	std::cout << "\n**Total Ticks: " << tot_ticks << std::endl;
 	std::cout << "\n**Ramulator Active Cycles: " << memory->ramulator_active_cycles.value() << std::endl;
 	std::cout << "\n**DRAM Cycles: " << memory->num_dram_cycles.value() << std::endl;
+	std::cout << "\n**Fast-forwarded Idle Cycles: " << ff_skipped_cycles
+			  << " (" << ff_ticks << " event ticks)" << std::endl;
 	std::cout << "\n**Maximum Bandwidth: " << memory->maximum_bandwidth.value() << std::endl;
 	std::cout << "\nNumber of Incoming Requests: " << memory->num_incoming_requests.value() << std::endl;
 	std::cout << "\n**Serving Request**\n";
@@ -57,15 +57,11 @@ DramModel::~DramModel()
 	std::cout << "[RAMULATOR OUTPUT]" << std::endl;
 
 	std::cout << std::endl << "[Latency-related OUTPUT]" << std::endl;
-	if (n_updates > 0) {
-		avg_req_num /= n_updates;
-		avg_update_time /= n_updates;
-		avg_mem_latency = avg_mem_latency / (2 * n_updates);
-	}
-	std::cout << "Total updates: " << n_updates << std::endl;
-	std::cout << "Average number of requests during one update: " << avg_req_num << std::endl;
-	std::cout << "Average time between two updates: " << avg_update_time << std::endl;
-	std::cout << "Average memory latency: " << avg_mem_latency << std::endl;
+	std::cout << "Reads: " << n_reads << ", average latency: "
+			  << (n_reads ? double(tot_read_latency) / n_reads : 0) << std::endl;
+	std::cout << "Writes: " << n_writes << ", average latency: "
+			  << (n_writes ? double(tot_write_latency) / n_writes : 0) << std::endl;
+	std::cout << "Cycles stalled on a full queue: " << tot_stall_cycles << std::endl;
 	std::cout << std::endl << "[Latency-related OUTPUT]" << std::endl;
 }
 
@@ -85,80 +81,84 @@ int DramModel::mask(int bits)
 	return (1 << bits) - 1;
 }
 
-bool DramModel::readRow(int vault, int bank, int row, int col)
+long DramModel::getAddr(int vault, int bank, int row, int col)
 {
-	RamRequest::Type type = RamRequest::Type::READ;
-	uint64_t addr = 0;
-	int bits = 0;
-	int rank = bank >> memory->addr_bits[2];
-	int ba = bank & mask(memory->addr_bits[2]);
+	/* 'bank' counts across the ranks, pseudo channels and bank groups of the vault */
+	int lev[int(Level::MAX)];
+	lev[int(Level::Channel)] = vault;
+	lev[int(Level::Rank)] = bank / spec->banks_per_rank();
+	spec->split_bank(bank % spec->banks_per_rank(), lev);
+	lev[int(Level::Row)] = row;
+	lev[int(Level::Column)] = col;
+
+	long addr = 0;
+	auto push = [&](int l) {
+		addr <<= memory->addr_bits[l];
+		addr |= (lev[l] & mask(memory->addr_bits[l]));
+	};
 	if (memory->type == RamMemory::Type::ChRaBaRoCo) {
-		addr = vault & mask(memory->addr_bits[0]);
-		addr <<= memory->addr_bits[1];
-		addr |= (rank & mask(memory->addr_bits[1]));
-		addr <<= memory->addr_bits[2];
-		addr |= (ba & mask(memory->addr_bits[2]));
-		addr <<= memory->addr_bits[3];
-		addr |= (row & mask(memory->addr_bits[3]));
-		addr <<= memory->addr_bits[4];
-		addr |= (col & mask(memory->addr_bits[4]));
-		
+		for (int l = 0; l < int(Level::MAX); l++)
+			push(l);
 	}
 	else if (memory->type == RamMemory::Type::RoBaRaCoCh) {
-		addr = row & mask(memory->addr_bits[3]);
-		addr <<= memory->addr_bits[2];
-		addr |= (ba & mask(memory->addr_bits[2]));
-		addr <<= memory->addr_bits[1];
-		addr |= (rank & mask(memory->addr_bits[1]));
-		addr <<= memory->addr_bits[4];
-		addr |= (col & mask(memory->addr_bits[4]));
-		addr <<= memory->addr_bits[0];
-		addr |= (vault & mask(memory->addr_bits[0]));
-	}
-	else {
-
+		for (int l = int(Level::Row); l > int(Level::Channel); l--)
+			push(l);
+		push(int(Level::Column));
+		push(int(Level::Channel));
 	}
 	//addr <<= memory->tx_bits;
-	RamRequest req(addr, type, read_complete);
+	return addr;
+}
+
+bool DramModel::readRow(int vault, int bank, int row, int col)
+{
+	RamRequest req(getAddr(vault, bank, row, col), RamRequest::Type::READ, read_complete);
 	return sendMemReq(req);
 }
 
 bool DramModel::writeRow(int vault, int bank, int row, int col)
 {
-	RamRequest::Type type = RamRequest::Type::WRITE;
-	uint64_t addr = 0;
-	int bits = 0;
-	int rank = bank >> memory->addr_bits[2];
-	int ba = bank & mask(memory->addr_bits[2]);
-	if (memory->type == RamMemory::Type::ChRaBaRoCo) {
-		addr = vault & mask(memory->addr_bits[0]);
-		addr <<= memory->addr_bits[1];
-		addr |= (rank & mask(memory->addr_bits[1]));
-		addr <<= memory->addr_bits[2];
-		addr |= (ba & mask(memory->addr_bits[2]));
-		addr <<= memory->addr_bits[3];
-		addr |= (row & mask(memory->addr_bits[3]));
-		addr <<= memory->addr_bits[4];
-		addr |= (col & mask(memory->addr_bits[4]));
+	RamRequest req(getAddr(vault, bank, row, col), RamRequest::Type::WRITE, read_complete);
+	return sendMemReq(req);
+}
 
+bool DramModel::post(RamRequest::Type type, int vault, int bank, int row, int col, function<void(RamRequest&)> callback)
+{
+	RamRequest req(getAddr(vault, bank, row, col), type, callback);
+	return sendMemReq(req);
+}
+
+int DramModel::access(RamRequest::Type type, int vault, int bank, int row, int col, uint64_t time_ns)
+{
+	fastForwardTo(time_ns);
+
+	long done = -1;
+	RamRequest req(getAddr(vault, bank, row, col), type,
+			[this, &done](RamRequest& r) {
+				done = r.depart;
+				if (r.type == RamRequest::Type::READ)
+					read_complete(r);
+			});
+
+	RamController* ctrl = memory->ctrls[vault];
+	long submit = ctrl->clk;
+	while (!sendMemReq(req)) {
+		memory->step();
 	}
-	else if (memory->type == RamMemory::Type::RoBaRaCoCh) {
-		addr = row & mask(memory->addr_bits[3]);
-		addr <<= memory->addr_bits[2];
-		addr |= (ba & mask(memory->addr_bits[2]));
-		addr <<= memory->addr_bits[1];
-		addr |= (rank & mask(memory->addr_bits[1]));
-		addr <<= memory->addr_bits[4];
-		addr |= (col & mask(memory->addr_bits[4]));
-		addr <<= memory->addr_bits[0];
-		addr |= (vault & mask(memory->addr_bits[0]));
+	tot_stall_cycles += ctrl->clk - submit;
+	while (done < 0) {
+		memory->step();
 	}
-	else {
 
+	int latency = int(done - submit);
+	if (type == RamRequest::Type::READ) {
+		n_reads++;
+		tot_read_latency += latency;
+	} else {
+		n_writes++;
+		tot_write_latency += latency;
 	}
-	//addr <<= memory->tx_bits;
-	RamRequest req(addr, type, read_complete);
-	return sendMemReq(req);
+	return latency;
 }
 
 void DramModel::tickOnce()
@@ -168,6 +168,40 @@ void DramModel::tickOnce()
 	tot_ticks ++;
 }
 
+long DramModel::cyclesTo(uint64_t time_ns)
+{
+	long target = long(time_ns / tCK);
+	long cur = long(memory->num_dram_cycles.value());
+	if (ff_clk_base < 0)
+		ff_clk_base = target - cur;
+	return target - ff_clk_base - cur;
+}
+
+void DramModel::fastForwardTo(uint64_t time_ns)
+{
+	long cycles = cyclesTo(time_ns);
+	if (cycles <= 0)
+		return;
+	long ticked = memory->fast_forward(cycles);
+	ff_ticks += ticked;
+	ff_skipped_cycles += cycles - ticked;
+	interval_ticks -= cycles;
+	tot_ticks += cycles;
+}
+
+bool DramModel::stepTowards(uint64_t time_ns)
+{
+	long cycles = cyclesTo(time_ns);
+	if (cycles <= 0)
+		return false;
+	long advanced = memory->advance(cycles);
+	ff_ticks++;
+	ff_skipped_cycles += advanced - 1;
+	interval_ticks -= advanced;
+	tot_ticks += advanced;
+	return true;
+}
+
 void DramModel::resetIntervalTick()
 {
 	interval_ticks = 500000;
@@ -178,63 +212,18 @@ void DramModel::setBankRef(int vault, int bank, bool hot)
 	memory->ctrls[vault]->setBankRef(bank, hot);
 }
 
-int DramModel::getReadLatency(int vault, int bank, int row, int col, uint64_t pkt_time)
+void DramModel::setBankTemp(int vault, int bank, RamSpec::Temp temp)
 {
-	//int rd_latency = memory->spec->read_latency;
-	Request req = {0, vault, bank, row, col};
-	//req_queue.push_back(req);
-	if (pkt_time - last_req_time > 200) { // update r/w latency
-		updateLatency(pkt_time);
-	}
-	return recent_read_latency;
+	memory->ctrls[vault]->update_temp(bank, temp);
 }
-int DramModel::getWriteLatency(int vault, int bank, int row, int col, uint64_t pkt_time)
+
+int DramModel::getReadLatency(int vault, int bank, int row, int col, uint64_t pkt_time)
 {
-	//int rd_latency = memory->spec->read_latency;
-	Request req = {1, vault, bank, row, col};
-	req_queue.push_back(req);
-	if (pkt_time - last_req_time > 200) { // update r/w latency
-		updateLatency(pkt_time);
-	}
-	return recent_write_latency;
+	return access(RamRequest::Type::READ, vault, bank, row, col, pkt_time);
 }
-void DramModel::updateLatency(uint64_t pkt_time)
+int DramModel::getWriteLatency(int vault, int bank, int row, int col, uint64_t pkt_time)
 {
-	if (pkt_time - last_req_time < 200) {
-		return;
-	}
-	//std::cout << req_queue.size() << std::endl;
-	uint64_t elapse_time = pkt_time - last_req_time;
-	n_updates++;
-	avg_update_time += elapse_time;
-	avg_req_num += req_queue.size();
-
-	last_req_time = pkt_time;
-
-	int read_clks = 0, write_clks = 0, n_reads = 0, n_writes = 0;
-	for (Request req : req_queue) {
-		bool stall = true;
-		n_reads = (req.type == 0) ? n_reads + 1 : n_reads;
-		n_writes = (req.type == 1) ? n_writes + 1 : n_writes;
-		while (stall) {
-			if (req.type == 0) {
-				read_clks++;
-				stall = this->readRow(req.vault, req.bank, req.row, req.col);
-			} else {
-				write_clks++;
-				stall = this->writeRow(req.vault, req.bank, req.row, req.col);
-			}
-		}
-	}
-	req_queue.clear();
-	req_queue.shrink_to_fit();
-
-	recent_read_latency = (n_reads == 0) ? 0 : read_clks / n_reads;
-	recent_write_latency = (n_writes == 0) ? 0 : write_clks / n_writes;
-	recent_read_latency += memory->spec->read_latency;
-	recent_write_latency += memory->spec->read_latency;
-
-	avg_mem_latency += recent_read_latency + recent_write_latency;
+	return access(RamRequest::Type::WRITE, vault, bank, row, col, pkt_time);
 }
 
 int DramModel::getPrevLatency()
@@ -270,6 +259,11 @@ uint64_t DramModel::getTotTime()
 	return dram_cycles * t_ck;
 }
 
+uint64_t DramModel::getDramCycles()
+{
+	return memory->num_dram_cycles.value();
+}
+
 double DramModel::getVaultQueLenAvg(int vault) 
 {
 	return double(memory->ctrls[vault]->req_queue_length_avg.value());
@@ -335,7 +329,7 @@ uint64_t DramModel::getBankRowMisses(int vault, int bank)
 
 uint64_t DramModel::getBankActTime(int vault, int bank)
 {
-	int rank = bank >> memory->addr_bits[2];
+	int rank = bank / spec->banks_per_rank();
 	uint64_t t_ck = (uint64_t)tCK;
 	uint64_t act_cycles = memory->ctrls[vault]->channel->children[rank]->active_cycles.value();
 	return act_cycles * t_ck;
@@ -343,7 +337,7 @@ uint64_t DramModel::getBankActTime(int vault, int bank)
 
 uint64_t DramModel::getBankRdTime(int vault, int bank)
 {
-	int rank = bank >> memory->addr_bits[2];
+	int rank = bank / spec->banks_per_rank();
 	uint64_t reads = memory->ctrls[vault]->bank_reads[bank].value();
 	uint64_t writes = memory->ctrls[vault]->bank_writes[bank].value();
 	uint64_t act_t = getBankActTime(vault, bank);
@@ -357,7 +351,7 @@ uint64_t DramModel::getBankRdTime(int vault, int bank)
 
 uint64_t DramModel::getBankWrTime(int vault, int bank)
 {
-	int rank = bank >> memory->addr_bits[2];
+	int rank = bank / spec->banks_per_rank();
 	uint64_t reads = memory->ctrls[vault]->bank_reads[bank].value();
 	uint64_t writes = memory->ctrls[vault]->bank_writes[bank].value();
 	uint64_t act_t = getBankActTime(vault, bank);
@@ -15,31 +15,24 @@
 #include <vector>
 
 /* Standards */
-#include "HBM.h"
+#include "RamSpec.h"
 
 using namespace std;
 using namespace ramulator;
 
 class DramModel {
 public:
-	struct Request {
-		int type;
-		int vault, bank, row, col;
-	};
-	vector<Request> req_queue;
-	int recent_read_latency, recent_write_latency;
-	uint64_t last_req_time = 0;
-	int n_updates = 0;
-	double avg_req_num = 0;
-	double avg_update_time;
-	double avg_mem_latency = 0;
+	/* Closed-loop accesses, latencies in DRAM cycles */
+	uint64_t n_reads = 0, n_writes = 0;
+	uint64_t tot_read_latency = 0, tot_write_latency = 0;
+	uint64_t tot_stall_cycles = 0;	// waiting for a full queue
 
 	DramModel();
 	DramModel(const std::string& fname);
 	~DramModel();
 	int R, C;
 	RamConfig* configs;
-	HBM* hbm;
+	RamSpec* spec;
 	// freq: MHz, tCK: ns
 	double freq, tCK;
 	std::vector<RamController*> ctlrs;
@@ -49,28 +42,52 @@ public:
 	function<void(RamRequest&)> read_complete;
 	long interval_ticks;
 	long tot_ticks;
+	/* idle cycles jumped over by fastForwardTo, ticks it really simulated */
+	uint64_t ff_skipped_cycles = 0, ff_ticks = 0;
+	/* DRAM cycle of time 0, set by the first fastForwardTo */
+	long ff_clk_base = -1;
 
 	void printSpec();
 
 	bool sendMemReq(RamRequest req);
 
 	int mask(int bits);
+	long getAddr(int vault, int bank, int row, int col);
 
 	bool readRow(int vault, int bank, int row, int col);
 	bool writeRow(int vault, int bank, int row, int col);
 
+	/* Submit a request at 'time_ns' and simulate until it completes
+	 * Returns the number of DRAM cycles from submission to completion:
+	 * queueing, bank timing and refresh contention with all other requests
+	 * in flight are included. The completion reaches read_complete as well. */
+	int access(RamRequest::Type type, int vault, int bank, int row, int col, uint64_t time_ns);
+
+	/* Submit a request without waiting for it, false if the queue of the vault is full */
+	bool post(RamRequest::Type type, int vault, int bank, int row, int col, function<void(RamRequest&)> callback);
+
 	void tickOnce();
+	/* Advance the DRAM clock to 'time_ns', at a cost proportional to the events on the way
+	 * The first call only aligns the DRAM clock with 'time_ns' */
+	void fastForwardTo(uint64_t time_ns);
+	/* Advance the DRAM clock to its next event, but not beyond 'time_ns'
+	 * Returns false if the clock has already reached 'time_ns' */
+	bool stepTowards(uint64_t time_ns);
+	/* DRAM cycles from the current clock to 'time_ns' */
+	long cyclesTo(uint64_t time_ns);
 	void resetIntervalTick();
 	void setBankRef(int vault, int bank, bool hot);
+	/* ALDRAM: use the timing of temperature class 'temp' for the bank */
+	void setBankTemp(int vault, int bank, RamSpec::Temp temp);
 
 	/* The unit of all time stats is "NS" */
 
 	int getReadLatency(int vault, int bank, int row, int col, uint64_t pkt_time);
 	int getWriteLatency(int vault, int bank, int row, int col, uint64_t pkt_time);
-	void updateLatency(uint64_t pkt_time);
 	int getPrevLatency();
 
 	uint64_t getTotTime();
+	uint64_t getDramCycles();
 
 	double getVaultQueLenAvg(int vault);
 	double getVaultQueLenSum(int vault);
@@ -1,7 +1,9 @@
 #include "remapping.h"
 
 BankStat::BankStat(UInt32 id) 
-	: _bank_id(id), _logical_id(id), _physical_id(id), _remap_id(id)
+	: _bank_id(id), _logical_id(id), _physical_id(id), _remap_id(id),
+	  _moved_from(id),
+	  hot_rows(_n_migrate_row)
 {
 	_valid = true;
 	_disabled = false;
@@ -15,24 +17,7 @@ BankStat::~BankStat()
 void
 BankStat::accessRow(UInt32 row_id)
 {
-	/* Here we use MEA method to select hottest rows*/
-	if (mea_map.find(row_id) != mea_map.end()) {
-		mea_map[row_id]++;
-	} else {
-		if (mea_map.size() < _n_migrate_row) {
-			mea_map[row_id] = 1;
-		} else {
-			std::vector<UInt32> deleted_keys;
-			for (auto i = mea_map.begin(); i != mea_map.end(); i++) {
-				i->second --;
-				if (i->second == 0) {
-					deleted_keys.push_back(i->first);
-				}
-			}
-			for (auto i : deleted_keys)
-				mea_map.erase(i);
-		}
-	}	
+	hot_rows.access(row_id);
 }
 
 void
@@ -69,6 +54,18 @@ BankStat::combineWith(BankStat* target_bank)
 	invalidate_times ++;
 }
 
+void
+BankStat::swapWith(BankStat* target_bank)
+{
+	/* swapping again with the same bank restores both */
+	UInt32 phy_id = _physical_id;
+	_physical_id = target_bank->_physical_id;
+	target_bank->_physical_id = phy_id;
+
+	remap_times ++;
+	target_bank->remap_times ++;
+}
+
 void
 BankStat::migrateRow(UInt32 row_id)
 {
@@ -85,10 +82,20 @@ BankStat::setId(UInt32 log_id, UInt32 phy_id)
 	_physical_id = phy_id;
 }
 
+void
+BankStat::setMigrateRows(UInt32 n_migrate_row)
+{
+	if (n_migrate_row == _n_migrate_row)
+		return;
+	_n_migrate_row = n_migrate_row;
+	hot_rows.resize(_n_migrate_row);
+}
+
 void
 BankStat::finishRemapping()
 {
 	valid_rows.clear();
+	_moved_from = _physical_id;
 }
 
 //---------------------------RemappingManager-------------------------------
@@ -113,6 +120,7 @@ RemappingManager::RemappingManager(StackedDramPerfUnison* dram_perf_cntlr)
 		BankStat* bank_stat = new BankStat(i);
 		_bank_stat.push_back(bank_stat);
 	}
+	buildTargets();
 }
 
 RemappingManager::~RemappingManager()
@@ -127,30 +135,56 @@ RemappingManager::~RemappingManager()
 	printf("----[REMAP OUTPUT]---\n");
 	printf("*****HotAccess: %ld\n*****CoolAccess: %ld\n*****RemapAccess: %ld\n",
 			tot_hot_access, tot_cool_access, tot_remap_access);
-	printf("*****SingleDisableTime: %d\n*****DoubleDisableTime: %d\n*****RemapTime: %d\n*****RecoveryTime: %d\n",
-			disable_times, double_disable_times, remap_times, recovery_times);
+	printf("*****SingleDisableTime: %d\n*****DoubleDisableTime: %d\n*****RemapTime: %d\n*****RecoveryTime: %d\n*****SwapTime: %d\n*****PredictedHotTime: %d\n",
+			disable_times, double_disable_times, remap_times, recovery_times, swap_times, predicted_hot_times);
 	printf("---------------------\n");
 }
 
 void 
-RemappingManager::setRemapConfig(UInt32 n_remap, bool inter_vault, UInt32 high_thres, UInt32 dangerous_thres, UInt32 remap_thres, UInt32 init_temp)
+RemappingManager::setRemapConfig(StackedDramConfig* config)
 {
-	_n_remap = n_remap;
-	_inter_vault = inter_vault;
+	_n_remap = config->n_remap;
+	_inter_vault = config->inter_vault;
+	_migration = config->migration;
 	// high temperature threshold -> remap
-	_high_thres = high_thres;
-	_dangerous_thres = dangerous_thres;
+	_high_thres = config->high_temp_thres;
+	_dangerous_thres = config->dangerous_temp_thres;
 	// safe temperature threshold -> deremap
-	_remap_thres = remap_thres;
+	_remap_thres = config->remap_temp_thres;
+
+	_init_temp = config->init_temp_thres;
+
+	for (UInt32 i = 0; i < _tot_banks; i++)
+		_bank_stat[i]->setMigrateRows(config->n_migrate_row);
+	/* inter_vault decides which banks share a heap */
+	buildTargets();
+}
 
-	_init_temp = init_temp;
+void
+RemappingManager::setForecast(ThermalForecast* forecast)
+{
+	_forecast = forecast;
+	/* the heaps are ordered by the decision temperature */
+	buildTargets();
 }
 
 void
-RemappingManager::updateTemperature(UInt32 v, UInt32 b, double temp)
+RemappingManager::updateTemperature(UInt32 v, UInt32 b, double temp, SubsecondTime now)
 {
 	UInt32 bank_id = getBankId(v, b);
 	_phy_banks[bank_id]._temperature = temp;
+	if (_forecast)
+		_forecast->update(bank_id, temp, now);
+	updateTarget(bank_id);
+}
+
+double
+RemappingManager::getDecisionTemp(UInt32 phy_bank)
+{
+	double temp = _phy_banks[phy_bank]._temperature;
+	if (_forecast && _forecast->forecast(phy_bank) > temp)
+		return _forecast->forecast(phy_bank);
+	return temp;
 }
 
 void
@@ -163,6 +197,8 @@ RemappingManager::resetBank(UInt32 bank_id)
 	UInt32 remap_bank = bank->_remap_id;
 
 	_phy_banks[phy_bank]._valid = true;
+	/* the queued copies of a restored bank are useless */
+	bank->transit_rows.clear();
 
 	if (_n_remap == 0) {
 		bank->setDisabled(false);
@@ -183,14 +219,23 @@ RemappingManager::resetBank(UInt32 bank_id)
 		}
 	} else if (_n_remap == 2) {
 		bank->setDisabled(false);
+		if (phy_bank != bank_id) {
+			/* swap back, the partner holds our physical bank */
+			bank->swapWith(_bank_stat[phy_bank]);
+		}
 	} else {
 		std::cout << "[Error] unrecognized remap policy!\n";
 	}
+	updateTarget(bank_id);
+	updateTarget(phy_bank);
+	updateTarget(log_bank);
+	updateTarget(remap_bank);
 }
 
 void
 RemappingManager::resetStats(bool reset)
 {
+	_changed_banks.clear();
 	for (UInt32 bank_id = 0; bank_id < _tot_banks; bank_id++) {
 		BankStat* bank = _bank_stat[bank_id];
 		UInt32 phy_id = bank->_physical_id;
@@ -198,7 +243,7 @@ RemappingManager::resetStats(bool reset)
 		bank->setValid(true);
 		bank->finishRemapping();
 		/* Here we reset all cool banks */
-		if (reset && _phy_banks[phy_id]._temperature < _high_thres) {
+		if (reset && getDecisionTemp(phy_id) < _high_thres) {
 			resetBank(bank_id);
 		} 
 	}
@@ -226,6 +271,39 @@ RemappingManager::checkValid(UInt32 v, UInt32 b, UInt32 r)
 	return bank->_valid;
 }
 
+bool
+RemappingManager::checkMoved(UInt32 v, UInt32 b, UInt32 r)
+{
+	UInt32 bank_id = getBankId(v, b);
+	return _bank_stat[bank_id]->moved();
+}
+
+void
+RemappingManager::markTransit(UInt32 v, UInt32 b, UInt32 r)
+{
+	_bank_stat[getBankId(v, b)]->transit_rows.insert(r);
+}
+
+bool
+RemappingManager::endTransit(UInt32 v, UInt32 b, UInt32 r)
+{
+	BankStat* bank = _bank_stat[getBankId(v, b)];
+	if (bank->transit_rows.empty())
+		return false;
+	return bank->transit_rows.erase(r) > 0;
+}
+
+bool
+RemappingManager::getMovedFrom(UInt32* v, UInt32* b)
+{
+	BankStat* bank = _bank_stat[getBankId(*v, *b)];
+	if (!bank->moved())
+		return false;
+	*v = bank->_moved_from / _n_banks;
+	*b = bank->_moved_from % _n_banks;
+	return true;
+}
+
 bool
 RemappingManager::checkDisabled(UInt32 v, UInt32 b, UInt32 r)
 {
@@ -253,6 +331,8 @@ RemappingManager::accessRow(UInt32 v, UInt32 b, UInt32 r)
 		else
 			_phy_banks[phy_bank]._cool_access ++;
 	}
+	if (_forecast)
+		_forecast->access(phy_bank);
 	bank->accessRow(r);
 }
 
@@ -270,7 +350,9 @@ RemappingManager::runMechanism()
 	for (UInt32 bank_id = 0; bank_id < _tot_banks; bank_id++) {
 		BankStat* bank = _bank_stat[bank_id];
 		UInt32 physical_bank = bank->_physical_id, logical_bank = bank->_logical_id;
-		double bank_temp = _phy_banks[physical_bank]._temperature;
+		double bank_temp = getDecisionTemp(physical_bank);
+		/* only the forecast says the bank is hot */
+		bool predicted = _phy_banks[physical_bank]._temperature < _high_thres;
 
 		if (_n_remap == 0) {
 			if (bank_temp < _remap_thres && bank->_disabled) {
@@ -284,6 +366,8 @@ RemappingManager::runMechanism()
 			}
 			if (bank_temp >= _high_thres && !bank->_disabled) {
 				hot_banks ++;
+				if (predicted)
+					predicted_hot_times ++;
 
 				disable_times ++;
 			//	printf("^^Hotbank! Disable it! ID(%d), TEMP(%.3lf)\n", bank_id, bank_temp);
@@ -292,6 +376,7 @@ RemappingManager::runMechanism()
 				bank->setDisabled(true);
 				bank->setValid(false);
 				_phy_banks[physical_bank]._valid = false;
+				updateTarget(bank_id);
 			}
 		} else if (_n_remap == 1) {
 			if (bank_temp < _remap_thres && (logical_bank != bank_id || bank->_disabled)) {
@@ -308,31 +393,14 @@ RemappingManager::runMechanism()
 			bool flag = false;
 			if (bank_temp >= _high_thres && bank->_combined == false && bank->_disabled == false) {
 				hot_banks++;
+				if (predicted)
+					predicted_hot_times ++;
 
 				//printf("^^Hotbank! Disable it! ID(%d), TEMP(%.3lf)\n", bank_id, bank_temp);
 				// this hot bank has not been remapped yet
-				UInt32 target = bank_id;
-				double min_temp = 1000.0;
-				UInt32 vault_id = bank_id / _n_banks;
-
-				UInt32 begin_i = vault_id, end_i = vault_id + _n_banks;
-				// check if we want a global remapping
-				if (_inter_vault) {
-					begin_i = 0; end_i = _tot_banks;
-				}
-				
-				for (UInt32 j = begin_i; j < end_i; j++) {
-					// Here we randomly choose a target to remap
-					UInt32 log_bank = _phy_banks[j]._logical_bank;
-					if (_bank_stat[log_bank]->_combined || _bank_stat[log_bank]->_disabled) continue;
-
-					if (_phy_banks[j]._temperature < _remap_thres) {
-						if (_phy_banks[j]._temperature < min_temp) {
-							target = log_bank;
-							min_temp = _phy_banks[j]._temperature;
-						}
-					}
-				}
+				UInt32 target = findTarget(bank_id);
+				if (target == INVALID_TARGET)
+					target = bank_id;
 				if (target == bank_id) {
 					flag = false;
 				} else {
@@ -344,6 +412,15 @@ RemappingManager::runMechanism()
 					BankStat* target_bank = _bank_stat[target];
 					bank->combineWith(target_bank);
 					_phy_banks[target]._valid = false;
+					if (_migration) {
+						/* the hottest rows follow the bank, the rest is invalidated */
+						vector<UInt32> rows;
+						bank->hot_rows.getHotRows(&rows);
+						for (UInt32 k = 0; k < rows.size(); k++)
+							bank->migrateRow(rows[k]);
+					}
+					updateTarget(bank_id);
+					updateTarget(target);
 				}
 			}
 			/*TODO: 
@@ -372,6 +449,8 @@ RemappingManager::runMechanism()
 							bank->setDisabled(true);
 							bank->setValid(false);
 							_phy_banks[physical_bank]._valid = false;
+							updateTarget(bank_id);
+							updateTarget(bank->_remap_id);
 						} else {
 							// already remapped to another bank
 							// hope that bank is cool...
@@ -385,21 +464,150 @@ RemappingManager::runMechanism()
 						bank->setDisabled(true);
 						bank->setValid(false);
 						_phy_banks[physical_bank]._valid = false;
+						updateTarget(bank_id);
 					}
 				} else {
 					// already a disable bank
 				}
 			}
 		} else if (_n_remap == 2) {
+			/* swapped: the content lives in physical_bank, its own physical bank holds the partner */
+			bool swapped = (physical_bank != bank_id);
+			if ((bank->_disabled || swapped) && bank_temp < _remap_thres
+					&& getDecisionTemp(bank_id) < _remap_thres) {
+				recovery_times ++;
+				cool_banks ++;
+				// both physical banks are cool again, restore the mapping
+				resetBank(bank_id);
+				continue;
+			}
+			if (bank_temp >= _high_thres && !bank->_disabled) {
+				hot_banks ++;
+				if (predicted)
+					predicted_hot_times ++;
+				UInt32 target = swapped ? INVALID_TARGET : findTarget(bank_id);
+				if (target != INVALID_TARGET) {
+					// move the hot content to the coolest bank, and the cool content here
+					remap_times ++;
+					swap_times ++;
+					remap_banks ++;
+					bank->swapWith(_bank_stat[target]);
+					updateTarget(bank_id);
+					updateTarget(target);
+				} else if (!swapped || bank_temp >= _dangerous_thres) {
+					/* no cool bank left, or the bank we moved to got dangerously hot */
+					disable_times ++;
+					bank->setDisabled(true);
+					bank->setValid(false);
+					_phy_banks[physical_bank]._valid = false;
+					updateTarget(bank_id);
+				}
+			}
 		} else {
 			std::cout << "[Error] unrecognized policy!\n";
 		}
 	}
+	publishChanges();
 	//std::cout << "-----and we found " << hot_banks << " hot banks!\n";
 	//std::cout << "-----and we remap " << remap_banks << " hot banks!\n";
 	//std::cout << "-----and we enabled " << cool_banks << " banks!\n";
 }
 
+void
+RemappingManager::publishChanges()
+{
+	_changed_banks.clear();
+	for (UInt32 bank_id = 0; bank_id < _tot_banks; bank_id++) {
+		if (!_bank_stat[bank_id]->_valid || _bank_stat[bank_id]->moved()) {
+			_changed_banks.push_back(bank_id);
+		}
+	}
+}
+
+void
+RemappingManager::buildTargets()
+{
+	UInt32 n_groups = _inter_vault ? 1 : _n_vaults;
+	_target_heap.assign(n_groups, vector<UInt32>());
+	_target_pos.assign(_tot_banks, -1);
+	for (UInt32 j = 0; j < _tot_banks; j++)
+		updateTarget(j);
+}
+
+void
+RemappingManager::updateTarget(UInt32 phy_bank)
+{
+	/* callers pass bank ids: the _logical_bank of a physical bank never changes, so they are the same */
+	BankStat* bank = _bank_stat[_phy_banks[phy_bank]._logical_bank];
+	bool eligible = !bank->_combined && !bank->_disabled && bank->_physical_id == phy_bank;
+	vector<UInt32>& heap = _target_heap[getTargetGroup(phy_bank)];
+	int pos = _target_pos[phy_bank];
+
+	if (eligible && pos < 0) {
+		_target_pos[phy_bank] = heap.size();
+		heap.push_back(phy_bank);
+		targetSift(phy_bank);
+	} else if (eligible) {
+		targetSift(phy_bank);
+	} else if (pos >= 0) {
+		/* move the last bank to the hole and restore its order */
+		targetSwap(heap, pos, heap.size() - 1);
+		heap.pop_back();
+		_target_pos[phy_bank] = -1;
+		if ((UInt32)pos < heap.size())
+			targetSift(heap[pos]);
+	}
+}
+
+UInt32
+RemappingManager::findTarget(UInt32 bank_id)
+{
+	vector<UInt32>& heap = _target_heap[getTargetGroup(bank_id)];
+	if (heap.empty() || getDecisionTemp(heap[0]) >= _remap_thres)
+		return INVALID_TARGET;
+	return _phy_banks[heap[0]]._logical_bank;
+}
+
+bool
+RemappingManager::targetBefore(UInt32 phy_a, UInt32 phy_b)
+{
+	/* ties go to the lower index, as the linear scan did */
+	double a = getDecisionTemp(phy_a), b = getDecisionTemp(phy_b);
+	return a < b || (a == b && phy_a < phy_b);
+}
+
+void
+RemappingManager::targetSwap(vector<UInt32>& heap, UInt32 pos_a, UInt32 pos_b)
+{
+	std::swap(heap[pos_a], heap[pos_b]);
+	_target_pos[heap[pos_a]] = pos_a;
+	_target_pos[heap[pos_b]] = pos_b;
+}
+
+void
+RemappingManager::targetSift(UInt32 phy_bank)
+{
+	vector<UInt32>& heap = _target_heap[getTargetGroup(phy_bank)];
+	UInt32 pos = _target_pos[phy_bank];
+	// sift up
+	while (pos > 0 && targetBefore(phy_bank, heap[(pos - 1) / 2])) {
+		targetSwap(heap, pos, (pos - 1) / 2);
+		pos = (pos - 1) / 2;
+	}
+	// sift down
+	while (true) {
+		UInt32 child = 2 * pos + 1;
+		if (child >= heap.size())
+			break;
+		if (child + 1 < heap.size() && targetBefore(heap[child + 1], heap[child]))
+			child++;
+		if (!targetBefore(heap[child], phy_bank))
+			break;
+		targetSwap(heap, pos, child);
+		pos = child;
+	}
+}
+
 void
 RemappingManager::splitId(UInt32 idx, UInt32* v, UInt32* b, UInt32* r)
 {
@@ -422,7 +630,10 @@ RemappingManager::getPhysicalIndex(UInt32* v, UInt32* b, UInt32* r)
 	UInt32 bank_id = getBankId(*v, *b);
 	BankStat* bank = _bank_stat[bank_id];
 	UInt32 phy_bank = bank->_physical_id;
-	splitId(phy_bank, v, b, r);
+
+	UInt32 new_idx = phy_bank * _n_rows + *r;
+
+	splitId(new_idx, v, b, r);
 }
 
 void
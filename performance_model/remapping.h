@@ -15,6 +15,9 @@
 #include "fixed_types.h"
 
 #include "stacked_dram_cntlr.h"
+#include "stacked_dram_config.h"
+#include "hot_row_tracker.h"
+#include "thermal_forecast.h"
 
 #include <iostream>
 #include <fstream>
@@ -35,6 +38,11 @@ public:
 	 */
 	UInt32 _bank_id;
 	UInt32 _logical_id, _physical_id, _remap_id;
+	/*
+	 * moved_from: physical_id when the cache controller last handled the bank,
+	 *   the content has to be moved while it differs (swap remapping)
+	 */
+	UInt32 _moved_from;
 	/*
 	 * valid: indicate whether the content of bank is still valid
 	 * disabled: indicate whether the bank is disabled because of high temperature
@@ -42,10 +50,12 @@ public:
 	 */
 	bool _valid = true, _disabled = false, _combined = false;
 	std::unordered_set<UInt32> valid_rows;
+	/* Rows whose copy or write back is still queued (lazy migration) */
+	std::unordered_set<UInt32> transit_rows;
 
-	/* MEA map*/
-	std::map<UInt32, UInt32> mea_map;
+	/* Hottest rows, candidates for migration */
 	UInt32 _n_migrate_row = 10;
+	HotRowTracker hot_rows;
 
 	/* Statistics */
 	long remap_times = 0, disabled_times = 0, invalidate_times = 0;
@@ -58,10 +68,13 @@ public:
 	void accessRow(UInt32 row_id);
 	void remapTo(UInt32 phy_bank_id, bool disabled);
 	void combineWith(BankStat* target_bank);
+	void swapWith(BankStat* target_bank);
+	bool moved() {return _moved_from != _physical_id;}
 	void migrateRow(UInt32 row_id);
 	void setValid(bool valid) {_valid = valid;}
 	void setDisabled(bool disabled) {_disabled = disabled;}
 	void setId(UInt32 log_id, UInt32 phy_id);
+	void setMigrateRows(UInt32 n_migrate_row);
 	void finishRemapping();
 
 };
@@ -73,6 +86,7 @@ public:
 	UInt32 _tot_banks;
 	/* Experiment configurations */
 	bool _inter_vault = false;
+	bool _migration = false; // keep the hot rows of a combined bank
 	UInt32 _n_remap = 0;
 	UInt32 _high_thres, _dangerous_thres, _remap_thres;
 	UInt32 _init_temp;
@@ -83,20 +97,34 @@ public:
 		bool _valid;
 		long _hot_access, _cool_access, _remap_access;
 	};
-	int remap_times = 0, disable_times = 0, double_disable_times = 0, recovery_times = 0;
+	int remap_times = 0, disable_times = 0, double_disable_times = 0, recovery_times = 0, swap_times = 0;
+	int predicted_hot_times = 0; // hot handling of banks still below _high_thres
 	vector<PhyBank> _phy_banks;
 	vector<BankStat*> _bank_stat;
+	/* Remap targets: the eligible (neither combined nor disabled) physical
+	 * banks of each vault, of the whole stack with inter_vault, in an indexed
+	 * min-heap ordered by temperature */
+	vector<vector<UInt32> > _target_heap;
+	vector<int> _target_pos; // index of each physical bank in its heap, -1 if not eligible
+	/* Change-set of the last mechanism run: banks whose content is no longer valid
+	 * (their migrated rows are in BankStat::valid_rows) */
+	vector<UInt32> _changed_banks;
+	/* Predictive mode: decide on the forecast temperature, NULL if reactive */
+	ThermalForecast* _forecast = NULL;
 
-	
 
 	StackedDramPerfUnison* _m_dram_perf_cntlr;
 
 	RemappingManager(StackedDramPerfUnison* dram_perf_cntlr);
 	~RemappingManager();
 
-	void setRemapConfig(UInt32 n_remaps, bool inter_vault, UInt32 ht, UInt32 dt, UInt32 rt, UInt32 it);
+	/* Take the policy and thresholds from the configuration snapshot */
+	void setRemapConfig(StackedDramConfig* config);
 	
-	void updateTemperature(UInt32 v, UInt32 b, double temp);
+	void setForecast(ThermalForecast* forecast);
+	void updateTemperature(UInt32 v, UInt32 b, double temp, SubsecondTime now);
+	/* Temperature the mechanism acts on: the larger of the last and the forecast one */
+	double getDecisionTemp(UInt32 phy_bank);
 
 	void resetBank(UInt32 bank_id);
 	void resetStats(bool reset);
@@ -104,16 +132,36 @@ public:
 	bool checkMigrated(UInt32 v, UInt32 b, UInt32 r);
 	bool checkValid(UInt32 v, UInt32 b, UInt32 r);
 	bool checkDisabled(UInt32 v, UInt32 b, UInt32 r);
+	bool checkMoved(UInt32 v, UInt32 b, UInt32 r);
+	/* Rows in transit (lazy migration) */
+	void markTransit(UInt32 v, UInt32 b, UInt32 r);
+	/* Take a row out of transit, false if it was not in transit */
+	bool endTransit(UInt32 v, UInt32 b, UInt32 r);
+	/* Physical vault and bank the content of bank (v, b) is moved from, false if it is not moved */
+	bool getMovedFrom(UInt32* v, UInt32* b);
 	/* Access a row: update bank stats */
 	void accessRow(UInt32 v, UInt32 b, UInt32 r);
 
 	/* Do remapping-based thermal management */
 	void runMechanism();
+	/* Collect the banks invalidated by runMechanism into _changed_banks */
+	void publishChanges();
+
+	/* Remap target heaps */
+	void buildTargets();
+	/* Insert, remove or re-sift a physical bank after its state or temperature changed */
+	void updateTarget(UInt32 phy_bank);
+	/* Coolest eligible bank below _remap_thres for a hot bank, INVALID_TARGET if none */
+	UInt32 findTarget(UInt32 bank_id);
+	bool targetBefore(UInt32 phy_a, UInt32 phy_b);
+	void targetSwap(vector<UInt32>& heap, UInt32 pos_a, UInt32 pos_b);
+	void targetSift(UInt32 phy_bank);
 	
 
 	/* Get the index information: bank, row...*/
 
 	void splitId(UInt32 idx, UInt32* v, UInt32* b, UInt32* r);
+	UInt32 getTargetGroup(UInt32 phy_bank) { return _inter_vault ? 0 : phy_bank / _n_banks; }
 	UInt32 getBankId(UInt32 v, UInt32 b);
 	void getPhysicalIndex(UInt32* v, UInt32* b, UInt32* r);
 	void getLogicalIndex(UInt32* v, UInt32* b, UInt32* r);
@@ -1,4 +1,5 @@
 #include "stacked_dram_cntlr.h"
+#include "hooks_manager.h"
 
 #include <iostream>
 #include <fstream>
@@ -117,6 +118,10 @@ StackedDramPerfUnison::StackedDramPerfUnison(UInt32 vaults_num, UInt32 vault_siz
 
 	n_rows = m_bank_size / m_row_size;
 
+	vault_bit = floorLog2(n_vaults);
+	bank_bit = floorLog2(n_banks);
+	row_bit = floorLog2(n_rows);
+
 	m_vaults_array = new VaultPerfModel*[n_vaults];
 	for (UInt32 i = 0; i < n_vaults; i++) {
 		m_vaults_array[i] = new VaultPerfModel(vault_size, bank_size, row_size);
@@ -125,33 +130,18 @@ StackedDramPerfUnison::StackedDramPerfUnison(UInt32 vaults_num, UInt32 vault_siz
 	//m_vremap_table = new VaultRemappingStructure(vaults_num);
 	/* (REMAP_MAN) Remapping Managere, policy defined here*/
 	m_remap_manager = new RemappingManager(this);
+	m_forecast = NULL;
 
 	/*
 	Here we set the configuration for experiments using config file
 	 */
-	UInt32 c_max_remap_num = Sim()->getCfg()->getInt("perf_model/remap_config/max_remap_time");
-	UInt32 c_row_access_threshold = Sim()->getCfg()->getInt("perf_model/remap_config/row_access_threshold");
-	bool c_cross = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/cross", true);
-	bool c_invalid = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/invalidation", true);
-	bool c_mig = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/migration", false);
-	bool c_mea = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/mea", false);
-	UInt32 high_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/high_temp_thres");
-	UInt32 dangerous_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/dangerous_temp_thres");
-	UInt32 init_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/init_temp_thres");
-	UInt32 remap_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/remap_temp_thres");
-	enable_remap = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/remap", false);
-	reactive = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/reactive", false);
-	predictive = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/predictive", false);
-	no_hot_access = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/no_hot_access", false);
-
-	/*[NEW_EXP] Such a mess !!*/
-	int n_remap = Sim()->getCfg()->getInt("perf_model/remap_config/n_remap");
-	bool inter_vault = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/inter_vault", false);
-	m_remap_manager->setRemapConfig(n_remap, inter_vault, high_temp_thres, dangerous_temp_thres, remap_temp_thres, init_temp_thres);
+	m_config = StackedDramConfig::getSingleton();
+	applyConfig();
+	/* scripts may change the configuration until the region of interest starts */
+	Sim()->getHooksManager()->registerHook(HookType::HOOK_ROI_BEGIN, __refreshConfig, (UInt64)this, HooksManager::ORDER_NOTIFY_PRE);
 
 	remapped = false;
 	enter_roi = false;
-	bank_level_refresh = Sim()->getCfg()->getBoolDefault("perf_model/thermal/bank_level_refresh", false);
 
 	v_remap_times = b_remap_times = 0;
 
@@ -163,9 +153,8 @@ StackedDramPerfUnison::StackedDramPerfUnison(UInt32 vaults_num, UInt32 vault_siz
 	/*
 	   Initial DRAM simulator (ramulator)
 	*/
-	char *ram_config_file = "./ramulator/configs/HBM-config.cfg";
-	m_dram_model = new DramModel(ram_config_file);
-	first_req = true;
+	m_dram_model = new DramModel(m_config->ramulator_config.c_str());
+	m_migration = new MigrationEngine(m_dram_model, n_vaults, StackedBlockSize, m_config->migration_window);
 }
 
 StackedDramPerfUnison::~StackedDramPerfUnison()
@@ -175,8 +164,36 @@ StackedDramPerfUnison::~StackedDramPerfUnison()
 
 	delete [] m_vaults_array;
 	//delete m_vremap_table;
+	delete m_migration;
 	delete m_dram_model;
 	delete m_remap_manager;
+	delete m_forecast;
+}
+
+void
+StackedDramPerfUnison::applyConfig()
+{
+	enable_remap = m_config->remap;
+	reactive = m_config->reactive;
+	predictive = m_config->predictive;
+	no_hot_access = m_config->no_hot_access;
+	bank_level_refresh = m_config->bank_level_refresh;
+
+	m_remap_manager->setRemapConfig(m_config);
+
+	/* predictive: act on the bank temperature expected at the next interval */
+	if (predictive && m_forecast == NULL) {
+		const char* lcf_file = m_config->thermal_reverse ? "./HotSpot/reverse_3D.lcf" : "./HotSpot/test_3D.lcf";
+		m_forecast = new ThermalForecast(n_vaults * n_banks, lcf_file, m_config->access_energy);
+	}
+	m_remap_manager->setForecast(predictive ? m_forecast : NULL);
+}
+
+void
+StackedDramPerfUnison::refreshConfig()
+{
+	m_config->refresh();
+	applyConfig();
 }
 
 UInt32
@@ -193,9 +210,8 @@ StackedDramPerfUnison::getRemapSet(UInt32 set_i)
 	UInt32 remap_vault = vault_i, remap_bank = bank_i, remap_row = row_i;
 	m_remap_manager->getLogicalIndex(&remap_vault, &remap_bank, &remap_row);
 	UInt32 remap_set = getSetNum(remap_vault, remap_bank, remap_row);
-	int n_remap = Sim()->getCfg()->getInt("perf_model/remap_config/n_remap");
 	//bool global_remap = Sim()->getCfg()->getBoolean("perf_model/remap_config/inter_vault");
-	if (n_remap != 1 && remap_set != set_i) { 
+	if (m_config->n_remap != 1 && remap_set != set_i) { 
 		std::cout << "[Error] impossible set number!" << set_i << ", " << remap_set << std::endl;
 	}
 	//remap_set = set_i;
@@ -219,11 +235,7 @@ StackedDramPerfUnison::getRemapSet(UInt32 set_i)
 void 
 StackedDramPerfUnison::splitSetNum(UInt32 set_i, UInt32* vault_i, UInt32* bank_i, UInt32* row_i)
 {
-	UInt32 vault_bit = floorLog2(n_vaults);
-	UInt32 bank_bit = floorLog2(m_vault_size / m_bank_size);
-	UInt32 row_bit = floorLog2(m_bank_size / m_row_size);
-
-	int set_addr_map =  Sim()->getCfg()->getInt("perf_model/dram_cache/addr_map");
+	UInt32 set_addr_map = m_config->addr_map;
 
 	if (set_addr_map == 1) { // v_b_r
 		*vault_i = set_i >> row_bit >> bank_bit;
@@ -246,11 +258,7 @@ StackedDramPerfUnison::splitSetNum(UInt32 set_i, UInt32* vault_i, UInt32* bank_i
 UInt32 
 StackedDramPerfUnison::getSetNum(UInt32 vault_i, UInt32 bank_i, UInt32 row_i)
 {
-	UInt32 vault_bit = floorLog2(n_vaults);
-	UInt32 bank_bit = floorLog2(m_vault_size / m_bank_size);
-	UInt32 row_bit = floorLog2(m_bank_size / m_row_size);
-
-	int set_addr_map =  Sim()->getCfg()->getInt("perf_model/dram_cache/addr_map");
+	UInt32 set_addr_map = m_config->addr_map;
 	UInt32 set_i = 0;
 
 	if (set_addr_map == 1) { // v_b_r
@@ -280,8 +288,7 @@ StackedDramPerfUnison::getAccessLatency(
 						DramCntlrInterface::access_t access_type)
 {
 	// bandwidth of DRAM, decides how many request we need
-	int max_block = 128;
-	max_block = Sim()->getCfg()->getInt("perf_model/stacked_dram/max_block");
+	int max_block = m_config->max_block;
 	
 	int req_times = pkt_size / max_block;
 	if (req_times < 1) {
@@ -340,25 +347,13 @@ StackedDramPerfUnison::getAccessLatency(
 	   ----SOMETHING_ELSE----
 	   Handle the fine grained stats in new model
 	*/
-	// We may need to tick memory during idle time
-	UInt64 interval_ns = pkt_time.getNS() - last_req.getNS();
-	UInt64 clk_elasped = interval_ns / int(m_dram_model->tCK);
-	if (pkt_time < last_req) {
-		clk_elasped = 0;
-	}
-	if (clk_elasped > 1e4) {
-		//std::cout << "[Ramulator] Too many ticks required!\n";
-		clk_elasped = 1e4;
-	}
-	/*
-	if (first_req) {
-		first_req = false;
-	} else {
-		for (UInt64 i = 0; i < clk_elasped; i++) {
-			m_dram_model->tickOnce();
-		}
+	// Simulate the idle time since the last request,
+	// the model jumps from event to event instead of ticking every cycle
+	// Pending copies of swapped banks use the idle time first
+	if (pkt_time > last_req) {
+		m_migration->runUntil(pkt_time.getNS());
+		m_dram_model->fastForwardTo(pkt_time.getNS());
 	}
-	*/
 	/* Set the current time for ramulator
 	TODO: More concrete 
 	*/
@@ -386,9 +381,9 @@ TODO: Here we need to handle memory request with physical index
 
 		bool stall = true;
 		UInt32 clks = 0;
+		m_migration->beginDemand(remapVault);
 		if (access_type == DramCntlrInterface::READ) {
 			//stall = !m_dram_model->readRow(remapVault, remapBank, remapRow, 0);
-			m_dram_model->tickOnce();
 			clks += m_dram_model->getReadLatency(remapVault, remapBank, remapRow, 0, pkt_time.getNS());
 			/*
 			while (stall) {
@@ -399,7 +394,6 @@ TODO: Here we need to handle memory request with physical index
 			*/
 		} else if (access_type == DramCntlrInterface::WRITE) {
 			//stall = !m_dram_model->writeRow(remapVault, remapBank, remapRow, 0);
-			m_dram_model->tickOnce();
 			clks += m_dram_model->getWriteLatency(remapVault, remapBank, remapRow, 0, pkt_time.getNS());
 			/*
 			while (stall) {
@@ -414,6 +408,7 @@ TODO: Here we need to handle memory request with physical index
 			m_dram_model->tickOnce();
 			m_dram_model->tickOnce();
 		}
+		m_migration->endDemand(remapVault, clks);
 		//clks += m_dram_model->getReadLatency(remapVault);
 		//clks += m_dram_model->getPrevLatency();
 		//int prev_latency = m_dram_model->getPrevLatency();
@@ -425,8 +420,7 @@ TODO: Here we need to handle memory request with physical index
 		double tCK = m_dram_model->tCK;
 		double current_freq_level = Sim()->getStatsManager()->freq_lev;
 		double current_freq = Sim()->getStatsManager()->freq_table[current_freq_level];
-		bool on_top = Sim()->getCfg()->getBoolDefault("perf_model/stacked_dram/on_top", true);
-		if (on_top) {
+		if (m_config->on_top) {
 			tCK = 1000.0 / current_freq;
 		}
 		UInt64 latency_ns = tCK * clks;
@@ -435,9 +429,6 @@ TODO: Here we need to handle memory request with physical index
 
 		tot_clks += clks;
 	}
-	int bandwidth_3d = Sim()->getCfg()->getInt("perf_model/stacked_dram/bandwidth");
-	int rounded_latency_ns = pkt_size / bandwidth_3d;
-	rounded_latency_ns += 1;
 	//process_latency += Subsecond::NS(rounded_latency);
 	return process_latency;
 }
@@ -503,6 +494,69 @@ StackedDramPerfUnison::checkRowDisabled(UInt32 vault_i, UInt32 bank_i, UInt32 ro
 	return m_remap_manager->checkDisabled(vault_i, bank_i, row_i);
 }
 
+bool
+StackedDramPerfUnison::checkRowMoved(UInt32 vault_i, UInt32 bank_i, UInt32 row_i)
+{
+	return m_remap_manager->checkMoved(vault_i, bank_i, row_i);
+}
+
+void
+StackedDramPerfUnison::migrateSet(UInt32 set_i, UInt32 n_blocks)
+{
+	UInt32 vault_i = 0, bank_i = 0, row_i = 0;
+	splitSetNum(set_i, &vault_i, &bank_i, &row_i);
+
+	UInt32 src_vault = vault_i, src_bank = bank_i;
+	if (!m_remap_manager->getMovedFrom(&src_vault, &src_bank))
+		return;
+	UInt32 dst_vault = vault_i, dst_bank = bank_i, dst_row = row_i;
+	m_remap_manager->getPhysicalIndex(&dst_vault, &dst_bank, &dst_row);
+
+	m_migration->enqueue(src_vault, src_bank, row_i, dst_vault, dst_bank, dst_row, n_blocks);
+}
+
+void
+StackedDramPerfUnison::startMigration(UInt32 set_i, UInt32 n_blocks)
+{
+	UInt32 vault_i = 0, bank_i = 0, row_i = 0;
+	splitSetNum(set_i, &vault_i, &bank_i, &row_i);
+	UInt32 src_vault = vault_i, src_bank = bank_i, src_row = row_i;
+	m_remap_manager->getPhysicalIndex(&src_vault, &src_bank, &src_row);
+
+	/* the row is served by the set of the bank it was combined with */
+	UInt32 dst_vault = 0, dst_bank = 0, dst_row = 0;
+	splitSetNum(getRemapSet(set_i), &dst_vault, &dst_bank, &dst_row);
+	m_remap_manager->getPhysicalIndex(&dst_vault, &dst_bank, &dst_row);
+
+	m_remap_manager->markTransit(vault_i, bank_i, row_i);
+	m_migration->enqueue(src_vault, src_bank, src_row, dst_vault, dst_bank, dst_row, n_blocks);
+}
+
+void
+StackedDramPerfUnison::startWriteback(UInt32 set_i, UInt32 n_blocks)
+{
+	UInt32 vault_i = 0, bank_i = 0, row_i = 0;
+	splitSetNum(set_i, &vault_i, &bank_i, &row_i);
+	UInt32 src_vault = vault_i, src_bank = bank_i, src_row = row_i;
+	m_remap_manager->getPhysicalIndex(&src_vault, &src_bank, &src_row);
+
+	m_remap_manager->markTransit(vault_i, bank_i, row_i);
+	m_migration->enqueueWriteback(src_vault, src_bank, src_row, n_blocks);
+}
+
+UInt32
+StackedDramPerfUnison::claimMigration(UInt32 set_i, bool* writeback)
+{
+	UInt32 vault_i = 0, bank_i = 0, row_i = 0;
+	splitSetNum(set_i, &vault_i, &bank_i, &row_i);
+	if (!m_remap_manager->endTransit(vault_i, bank_i, row_i))
+		return 0;
+
+	UInt32 src_vault = vault_i, src_bank = bank_i, src_row = row_i;
+	m_remap_manager->getPhysicalIndex(&src_vault, &src_bank, &src_row);
+	return m_migration->claim(src_vault, src_bank, src_row, writeback);
+}
+
 bool
 StackedDramPerfUnison::checkSetDisabled(UInt32 set_i)
 {
@@ -511,6 +565,12 @@ StackedDramPerfUnison::checkSetDisabled(UInt32 set_i)
 	return checkRowDisabled(vault_i, bank_i, row_i);
 }
 
+const std::vector<UInt32>&
+StackedDramPerfUnison::getChangedBanks()
+{
+	return m_remap_manager->_changed_banks;
+}
+
 void
 StackedDramPerfUnison::checkDramValid(bool *valid_arr, UInt32* b_valid_arr, UInt32* b_migrated_arr)
 {
@@ -594,13 +654,13 @@ StackedDramPerfUnison::clearCacheStats()
 }
 
 void
-StackedDramPerfUnison::updateTemperature(UInt32 v, UInt32 b, double temperature, double v_temp)
+StackedDramPerfUnison::updateTemperature(UInt32 v, UInt32 b, double temperature, double v_temp, SubsecondTime now)
 {
-	UInt32 high_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/high_temp_thres");
+	UInt32 high_temp_thres = m_config->high_temp_thres;
 	if (Sim()->getMagicServer()->inROI()) {
 		enter_roi = true;
 	}
-	m_remap_manager->updateTemperature(v, b, temperature);
+	m_remap_manager->updateTemperature(v, b, temperature, now);
 
 		/*[NEW_EXP] here we set the flag*/
 		remapped = true;
@@ -617,6 +677,16 @@ StackedDramPerfUnison::updateTemperature(UInt32 v, UInt32 b, double temperature,
 		if (bank_level_refresh)
 			m_dram_model->setBankRef(v, b, false);
 	}
+
+	/* ALDRAM: reduced timing for cold banks, a guardband for hot ones */
+	if (m_config->aldram) {
+		RamSpec::Temp temp = RamSpec::Temp::Normal;
+		if (temperature <= m_config->aldram_cold_temp)
+			temp = RamSpec::Temp::Cold;
+		else if (temperature >= m_config->aldram_hot_temp)
+			temp = RamSpec::Temp::Hot;
+		m_dram_model->setBankTemp(v, b, temp);
+	}
 	/*[NEW_EXP] here we need to manage the data
 	 * 1. find out all hot banks in the current system
 	 * 2. choose what kind of operation we need to take
@@ -17,7 +17,10 @@
 #include <fstream>
 
 #include "ramulator/dram_sim.h"
+#include "migration_engine.h"
 #include "remapping.h"
+#include "thermal_forecast.h"
+#include "stacked_dram_config.h"
 
 #include "magic_server.h"
 #include "config.hpp"
@@ -53,8 +56,12 @@ class StackedDramPerfUnison {
 		UInt32 m_vault_size;
 		UInt32 m_bank_size;
 		UInt32 m_row_size;
+		UInt32 vault_bit, bank_bit, row_bit;
 		UInt32 tot_reads, tot_writes, tot_misses;
 
+		/* Configuration snapshot, resolved once (see refreshConfig) */
+		StackedDramConfig* m_config;
+
 		SubsecondTime last_req = SubsecondTime::Zero();
 
 		/* structure for vault remapping*/
@@ -97,7 +104,10 @@ TODO: we need to consider vault parrellelism
 
 		//Dram Model (ramulator)
 		DramModel* m_dram_model;
-		bool first_req;
+		/* Copies the content of swapped banks in idle DRAM cycles */
+		MigrationEngine* m_migration;
+		/* Bank temperature forecast of the predictive mode, NULL if reactive */
+		ThermalForecast* m_forecast;
 
 		VaultPerfModel** m_vaults_array;
 		std::ofstream log_file;
@@ -105,6 +115,10 @@ TODO: we need to consider vault parrellelism
 		StackedDramPerfUnison(UInt32 vaults_num, UInt32 vault_size, UInt32 bank_size, UInt32 row_size);
 		~StackedDramPerfUnison();
 
+		/* Re-read the configuration after the simulation reconfigures (HOOK_ROI_BEGIN) */
+		void refreshConfig();
+		static SInt64 __refreshConfig(UInt64 arg0, UInt64 arg1) { ((StackedDramPerfUnison*)arg0)->refreshConfig(); return 0; }
+
 		/* New Remap Function*/
 		UInt32 getRemapSet(UInt32 set_i);
 		void splitSetNum(UInt32 set_i, UInt32* vault_i, UInt32* bank_i, UInt32* row_i);
@@ -115,7 +129,18 @@ TODO: we need to consider vault parrellelism
 		bool checkRowValid(UInt32 vault_i, UInt32 bank_i, UInt32 row_i);
 		bool checkRowMigrated(UInt32 vault_i, UInt32 bank_i, UInt32 row_i);
 		bool checkRowDisabled(UInt32 v, UInt32 b, UInt32 r);
+		bool checkRowMoved(UInt32 v, UInt32 b, UInt32 r);
+		/* Queue the copy of 'n_blocks' blocks of a set whose bank was swapped */
+		void migrateSet(UInt32 set_i, UInt32 n_blocks);
+		/* Lazy migration: put the row of a set in transit, and queue the copy of its
+		 * blocks to the combined bank, or the read of its dirty blocks to write back */
+		void startMigration(UInt32 set_i, UInt32 n_blocks);
+		void startWriteback(UInt32 set_i, UInt32 n_blocks);
+		/* Blocks of a set in transit the demand access has to move itself */
+		UInt32 claimMigration(UInt32 set_i, bool* writeback);
 		bool checkSetDisabled(UInt32 set_i);
+		/* Banks (vault * n_banks + bank) affected by the last remapping */
+		const std::vector<UInt32>& getChangedBanks();
 
 		void checkDramValid(bool *valid_arr, UInt32 *b_valid_arr, UInt32 *b_migrated_arr);
 		void checkTemperature(UInt32 idx, UInt32 bank_i);
@@ -126,10 +151,12 @@ TODO: we need to consider vault parrellelism
 		void clearRemappingStat();
 		void updateStats();
 		void clearCacheStats();
-		void updateTemperature(UInt32 v, UInt32 b, double temperature, double v_temp);
+		void updateTemperature(UInt32 v, UInt32 b, double temperature, double v_temp, SubsecondTime now);
 
 	private:
 		UInt32 *bankRemap;
+
+		void applyConfig();
 };
 
 class StackedDramPerfAlloy {
@@ -0,0 +1,91 @@
+#include "stacked_dram_config.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "dram_cache_page_table.h"
+#include "dram_cache_replacement.h"
+
+StackedDramConfig* StackedDramConfig::m_singleton = NULL;
+
+StackedDramConfig*
+StackedDramConfig::getSingleton()
+{
+	if (m_singleton == NULL) {
+		m_singleton = new StackedDramConfig();
+	}
+	return m_singleton;
+}
+
+StackedDramConfig::StackedDramConfig()
+{
+	load();
+	refresh();
+}
+
+StackedDramConfig::~StackedDramConfig()
+{
+}
+
+void
+StackedDramConfig::load()
+{
+	/* Keys the models have always required stay required (getInt/getFloat),
+	 * the optional ones keep the defaults the models used before */
+	ramulator_config = Sim()->getCfg()->getStringDefault("perf_model/stacked_dram/ramulator_config", "./ramulator/configs/HBM-config.cfg");
+	max_remap_time = Sim()->getCfg()->getInt("perf_model/remap_config/max_remap_time");
+	row_access_threshold = Sim()->getCfg()->getInt("perf_model/remap_config/row_access_threshold");
+	cross = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/cross", true);
+	invalidation = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/invalidation", true);
+	mea = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/mea", false);
+	remap_interval = Sim()->getCfg()->getInt("perf_model/remap_config/remap_interval");
+	migration_window = Sim()->getCfg()->getIntDefault("perf_model/remap_config/migration_window", 4);
+	cache_size = Sim()->getCfg()->getInt("perf_model/dram_cache/cache_size");
+	addr_map = Sim()->getCfg()->getInt("perf_model/dram_cache/addr_map");
+	fht_entries = Sim()->getCfg()->getIntDefault("perf_model/dram_cache/fht_entries", 4096);
+	fht_assoc = Sim()->getCfg()->getIntDefault("perf_model/dram_cache/fht_assoc", 4);
+	page_alloc = PageAllocPolicy::parse(Sim()->getCfg()->getStringDefault("perf_model/dram_cache/page_alloc", "sequential").c_str());
+	page_colors = Sim()->getCfg()->getIntDefault("perf_model/dram_cache/page_colors", 32);
+	tag_cache = Sim()->getCfg()->getBoolDefault("perf_model/dram_cache/tag_cache/enabled", false);
+	tag_cache_entries = Sim()->getCfg()->getIntDefault("perf_model/dram_cache/tag_cache/entries", 4096);
+	tag_cache_assoc = Sim()->getCfg()->getIntDefault("perf_model/dram_cache/tag_cache/assoc", 8);
+	replacement = DramCacheReplPolicy::parse(Sim()->getCfg()->getStringDefault("perf_model/dram_cache/replacement", "lru").c_str());
+	map_g = Sim()->getCfg()->getBoolDefault("perf_model/dram_cache/map_g/enabled", false);
+	batman = Sim()->getCfg()->getBoolDefault("perf_model/dram_cache/batman/enabled", false);
+	batman_target_hit_rate = Sim()->getCfg()->getFloatDefault("perf_model/dram_cache/batman/target_hit_rate", 0.8);
+	batman_epoch = Sim()->getCfg()->getIntDefault("perf_model/dram_cache/batman/epoch", 1000);
+	batman_latency_threshold = Sim()->getCfg()->getFloatDefault("perf_model/dram_cache/batman/latency_threshold", 2);
+	per_controller_bandwidth = Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth");
+	dram_latency = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/latency"))); // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
+	dram_latency_stddev = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/normal/standard_deviation")));
+	queue_model = Sim()->getCfg()->getBool("perf_model/dram/queue_model/enabled");
+	queue_model_type = queue_model ? Sim()->getCfg()->getString("perf_model/dram/queue_model/type") : "";
+}
+
+void
+StackedDramConfig::refresh()
+{
+	max_block = Sim()->getCfg()->getInt("perf_model/stacked_dram/max_block");
+	bandwidth = Sim()->getCfg()->getInt("perf_model/stacked_dram/bandwidth");
+	obus_delay = Sim()->getCfg()->getInt("perf_model/stacked_dram/obus_delay");
+	on_top = Sim()->getCfg()->getBoolDefault("perf_model/stacked_dram/on_top", true);
+	disabled = Sim()->getCfg()->getBoolDefault("perf_model/stacked_dram/disabled", false);
+	n_migrate_row = Sim()->getCfg()->getIntDefault("perf_model/remap_config/n_migrate_row", 10);
+	migration = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/migration", false);
+	lazy_migration = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/lazy_migration", false);
+	high_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/high_temp_thres");
+	dangerous_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/dangerous_temp_thres");
+	remap_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/remap_temp_thres");
+	init_temp_thres = Sim()->getCfg()->getInt("perf_model/remap_config/init_temp_thres");
+	remap = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/remap", false);
+	reactive = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/reactive", false);
+	predictive = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/predictive", false);
+	no_hot_access = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/no_hot_access", false);
+	n_remap = Sim()->getCfg()->getInt("perf_model/remap_config/n_remap");
+	inter_vault = Sim()->getCfg()->getBoolDefault("perf_model/remap_config/inter_vault", false);
+	avg_queue_latency = SubsecondTime::NS(Sim()->getCfg()->getInt("perf_model/dram/avg_queue_latency"));
+	bank_level_refresh = Sim()->getCfg()->getBoolDefault("perf_model/thermal/bank_level_refresh", false);
+	aldram = Sim()->getCfg()->getBoolDefault("perf_model/thermal/aldram/enabled", false);
+	aldram_cold_temp = Sim()->getCfg()->getIntDefault("perf_model/thermal/aldram/cold_temp", 55);
+	aldram_hot_temp = Sim()->getCfg()->getIntDefault("perf_model/thermal/aldram/hot_temp", 85);
+	thermal_reverse = Sim()->getCfg()->getBoolDefault("perf_model/thermal/reverse", false);
+	access_energy = Sim()->getCfg()->getFloatDefault("perf_model/thermal/access_energy", 2.0);
+}
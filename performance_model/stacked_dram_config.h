@@ -0,0 +1,98 @@
+#ifndef __STACKED_DRAM_CONFIG_H__
+#define __STACKED_DRAM_CONFIG_H__
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+/*
+ * Typed snapshot of the stacked DRAM configuration
+ *   (perf_model/stacked_dram, perf_model/remap_config, perf_model/dram_cache,
+ *    perf_model/dram and perf_model/thermal keys used by the DRAM cache)
+ * All values are resolved when the snapshot is created, so the per-access
+ * path of the cache controllers never parses a config string.
+ * refresh() only re-reads the keys the models look up at run time or that
+ * StackedDramPerfUnison::applyConfig() re-applies; the keys that size or
+ * build a model (cache geometry, FHT, tag cache, BATMAN, the DRAM queue
+ * model, ramulator, the remap interval of the stats) take effect only at
+ * construction and keep their first value.
+ */
+class StackedDramConfig {
+	public:
+		/* Re-read by refresh() */
+
+		/* perf_model/stacked_dram */
+		UInt32 max_block;
+		UInt32 bandwidth;
+		UInt32 obus_delay;
+		bool on_top;
+		bool disabled;
+
+		/* perf_model/remap_config */
+		UInt32 n_migrate_row;	// hot rows tracked per bank
+		bool migration;
+		bool lazy_migration;	// copy in the background or on the first access
+		UInt32 high_temp_thres, dangerous_temp_thres;
+		UInt32 remap_temp_thres, init_temp_thres;
+		bool remap, reactive, predictive, no_hot_access;
+		UInt32 n_remap;
+		bool inter_vault;
+
+		/* perf_model/dram */
+		SubsecondTime avg_queue_latency;
+
+		/* perf_model/thermal */
+		bool bank_level_refresh;
+		bool aldram;	// temperature-adaptive bank timing
+		UInt32 aldram_cold_temp, aldram_hot_temp;
+		bool thermal_reverse;	// processor on top of the DRAM stack
+		float access_energy;	// nJ per DRAM access, predictive remapping
+
+		/* Read once at construction */
+
+		/* perf_model/stacked_dram */
+		String ramulator_config;	// ramulator config file of the stacked DRAM
+
+		/* perf_model/remap_config */
+		UInt32 max_remap_time;
+		UInt32 row_access_threshold;
+		bool cross, invalidation, mea;
+		UInt32 remap_interval; // us
+		UInt32 migration_window;	// copy requests in flight per vault (swap)
+
+		/* perf_model/dram_cache */
+		UInt32 cache_size; // MB
+		UInt32 addr_map;	// fixes the set to vault/bank/row split, never changes mid-run
+		UInt32 fht_entries, fht_assoc;
+		UInt32 page_alloc;	// PageAllocPolicy::policy_t
+		UInt32 page_colors;
+		bool tag_cache;
+		UInt32 tag_cache_entries, tag_cache_assoc;
+		UInt32 replacement;	// DramCacheReplPolicy::policy_t
+		bool map_g;	// Alloy per-core miss predictor
+		bool batman;	// bandwidth-aware hit steering
+		float batman_target_hit_rate;
+		UInt32 batman_epoch;	// accesses
+		float batman_latency_threshold;	// average read latency / unloaded read latency
+
+		/* perf_model/dram */
+		float per_controller_bandwidth; // GB/s
+		SubsecondTime dram_latency;
+		SubsecondTime dram_latency_stddev;
+		bool queue_model;
+		String queue_model_type;
+
+		static StackedDramConfig* getSingleton();
+
+		/* Re-read the run-time keys from the simulator configuration */
+		void refresh();
+
+	private:
+		StackedDramConfig();
+		~StackedDramConfig();
+
+		void load();
+
+		static StackedDramConfig* m_singleton;
+};
+
+#endif /* __STACKED_DRAM_CONFIG_H__ */
@@ -0,0 +1,144 @@
+#include "thermal_forecast.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/* A 1mm x 1.5mm bank in 5 DRAM + 1 logic layers, if the floorplan cannot be read */
+#define DEFAULT_BANK_R 22.7
+#define DEFAULT_BANK_C 2.96e-3
+
+ThermalForecast::ThermalForecast(UInt32 n_banks, const char* lcf_file, double access_energy_nj)
+	: samples(0), sum_abs_err(0), sum_sq_err(0), max_abs_err(0),
+	  m_r(DEFAULT_BANK_R), m_c(DEFAULT_BANK_C),
+	  m_access_energy(access_energy_nj * 1e-9),
+	  m_accesses(n_banks, 0),
+	  m_temp(n_banks, 0), m_base(n_banks, 0), m_forecast(n_banks, 0),
+	  m_time(n_banks, SubsecondTime::Zero()),
+	  m_sampled(n_banks, false), m_fitted(n_banks, false)
+{
+	if (!loadFloorplan(lcf_file)) {
+		std::cout << "[Warning] cannot read the floorplan in " << lcf_file
+				  << ", the thermal forecast uses a default bank column!\n";
+	}
+	std::cout << "Thermal forecast: R " << m_r << " K/W, C " << m_c << " J/K, RC " << m_r * m_c * 1e3 << " ms\n";
+}
+
+ThermalForecast::~ThermalForecast()
+{
+	printf("----[FORECAST OUTPUT]---\n");
+	printf("*****Samples: %lu\n", (unsigned long)samples);
+	if (samples > 0) {
+		printf("*****MeanAbsError: %.3lf\n*****RMSError: %.3lf\n*****MaxAbsError: %.3lf\n",
+				sum_abs_err / samples, sqrt(sum_sq_err / samples), max_abs_err);
+	}
+	printf("---------------------\n");
+}
+
+bool
+ThermalForecast::loadFloorplan(const char* lcf_file)
+{
+	std::ifstream lcf(lcf_file);
+	if (!lcf.is_open())
+		return false;
+
+	/* layer number, lateral flow, power, specific heat, resistivity, thickness, floorplan */
+	std::vector<std::string> tokens;
+	std::string line, token;
+	while (std::getline(lcf, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream ss(line);
+		while (ss >> token)
+			tokens.push_back(token);
+	}
+	if (tokens.size() == 0 || tokens.size() % 7 != 0)
+		return false;
+
+	double area = 0;
+	for (UInt32 i = 0; i < tokens.size() && area == 0; i += 7)
+		area = unitArea(tokens[i + 6].c_str());
+	if (area == 0)
+		return false;
+
+	/* the column of a bank through every layer of the stack */
+	double r = 0, c = 0;
+	for (UInt32 i = 0; i < tokens.size(); i += 7) {
+		double specific_heat = atof(tokens[i + 3].c_str());
+		double resistivity = atof(tokens[i + 4].c_str());
+		double thickness = atof(tokens[i + 5].c_str());
+		r += resistivity * thickness / area;
+		c += specific_heat * thickness * area;
+	}
+	if (r <= 0 || c <= 0)
+		return false;
+	m_r = r;
+	m_c = c;
+	return true;
+}
+
+double
+ThermalForecast::unitArea(const char* flp_file)
+{
+	/* bank units are named dram_<vault>_<bank>, the controllers dram_ctlr_<vault> */
+	std::ifstream flp(flp_file);
+	std::string line, name;
+	double width, height;
+	while (std::getline(flp, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream ss(line);
+		if (!(ss >> name >> width >> height))
+			continue;
+		if (name.compare(0, 5, "dram_") == 0 && name.compare(0, 10, "dram_ctlr_") != 0)
+			return width * height;
+	}
+	return 0;
+}
+
+void
+ThermalForecast::update(UInt32 bank, double temp, SubsecondTime now)
+{
+	if (m_sampled[bank]) {
+		double err = fabs(temp - m_forecast[bank]);
+		samples ++;
+		sum_abs_err += err;
+		sum_sq_err += err * err;
+		if (err > max_abs_err)
+			max_abs_err = err;
+	}
+
+	double dt = m_sampled[bank] && now > m_time[bank] ? (now - m_time[bank]).getNS() * 1e-9 : 0;
+	if (dt <= 0) {
+		/* nothing to fit yet, expect the same temperature */
+		m_sampled[bank] = true;
+		m_temp[bank] = temp;
+		m_time[bank] = now;
+		m_forecast[bank] = temp;
+		m_accesses[bank] = 0;
+		return;
+	}
+
+	double power = m_accesses[bank] * m_access_energy / dt;
+	double decay = 1 - exp(-dt / (m_r * m_c));
+
+	/* the steady state the last interval was heading to, minus the bank's own share */
+	double base = m_temp[bank] + (temp - m_temp[bank]) / decay - m_r * power;
+	if (m_fitted[bank]) {
+		m_base[bank] += 0.25 * (base - m_base[bank]);
+	} else {
+		m_base[bank] = base;
+		m_fitted[bank] = true;
+	}
+
+	double steady = m_base[bank] + m_r * power;
+	m_forecast[bank] = temp + (steady - temp) * decay;
+
+	m_temp[bank] = temp;
+	m_time[bank] = now;
+	m_accesses[bank] = 0;
+}
@@ -0,0 +1,50 @@
+#ifndef __THERMAL_FORECAST_H__
+#define __THERMAL_FORECAST_H__
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+#include <vector>
+
+/*
+ * One-interval-ahead bank temperature forecast (predictive remapping)
+ *   Each bank is a first order RC column: R and C are summed over the layers
+ *   of the HotSpot layer configuration for the area of a bank unit of its
+ *   floorplan. The bank power is its access rate times an energy per access.
+ *   The rest of the stack (neighbours, processor, heat sink) is folded into
+ *   a base temperature per bank, fitted from the HotSpot samples:
+ *     T(t + dt) = T_ss + (T(t) - T_ss) * exp(-dt / RC),  T_ss = T_base + R * P
+ *   The forecast assumes that the next interval is as long and as busy as
+ *   the last one, and is scored against the next HotSpot sample.
+ */
+class ThermalForecast {
+	public:
+		ThermalForecast(UInt32 n_banks, const char* lcf_file, double access_energy_nj);
+		~ThermalForecast();
+
+		void access(UInt32 bank) { m_accesses[bank]++; }
+		/* HotSpot temperature of a bank at 'now': scores the last forecast and makes the next one */
+		void update(UInt32 bank, double temp, SubsecondTime now);
+		/* Expected temperature at the next sample, the last one if there is no forecast yet */
+		double forecast(UInt32 bank) const { return m_forecast[bank]; }
+
+		/* Forecast error against HotSpot */
+		UInt64 samples;
+		double sum_abs_err, sum_sq_err, max_abs_err;
+
+	private:
+		double m_r;	// K/W
+		double m_c;	// J/K
+		double m_access_energy;	// J
+
+		std::vector<UInt64> m_accesses;	// since the last sample
+		std::vector<double> m_temp, m_base, m_forecast;
+		std::vector<SubsecondTime> m_time;
+		std::vector<bool> m_sampled, m_fitted;
+
+		/* Fill m_r and m_c from the layer configuration, false if it cannot be read */
+		bool loadFloorplan(const char* lcf_file);
+		static double unitArea(const char* flp_file);
+};
+
+#endif /* __THERMAL_FORECAST_H__ */
@@ -18,7 +18,8 @@ StackedDramCacheCntlr::StackedDramCacheCntlr(
 	  m_pagesize(pagesize)
 {
 	std::cout << "Total set: " << set_num << std::endl;
-	m_set_info = new CacheSetInfoPageLRU(m_associativity);
+	m_set_info = new CacheSetInfoPageLRU(m_associativity, DramCacheReplPolicy::create(
+				(DramCacheReplPolicy::policy_t)StackedDramConfig::getSingleton()->replacement, m_associativity));
 
 	m_set = new CacheSetPageLRU*[m_set_num];	
 
@@ -29,7 +30,7 @@ StackedDramCacheCntlr::StackedDramCacheCntlr(
 	for (UInt32 i = 0; i < m_set_num; i++) {
 		UInt32 offset = i >> 12;
 		UInt32 vault_mask = (1ull << 5) - 1;
-		m_set[i] = new CacheSetPageLRU(m_associativity, m_blocksize, m_set_info);
+		m_set[i] = new CacheSetPageLRU(m_associativity, m_blocksize, m_set_info, i);
 
 		m_set[i]->n_vault = offset & vault_mask;
 		m_set[i]->n_bank = (i >> 11) & 1;
@@ -28,6 +28,7 @@
 #include "fixed_types.h"
 
 #include "cache_set_page_lru.h"
+#include "stacked_dram_config.h"
 
 
    class StackedDramCacheCntlr